@@ -57,6 +57,7 @@ private:
     QCheckBox* m_tabReplaceEnabledCheckbox;
     QSpinBox*  m_tabReplaceNumberSpinbox;
     QCheckBox* m_autoIndentationCheckbox;
+    QCheckBox* m_rainbowParenthesesCheckbox;
 
     QCodeEditor* m_codeEditor;
 
@@ -36,6 +36,7 @@ MainWindow::MainWindow(QWidget* parent) :
     m_tabReplaceEnabledCheckbox(nullptr),
     m_tabReplaceNumberSpinbox(nullptr),
     m_autoIndentationCheckbox(nullptr),
+    m_rainbowParenthesesCheckbox(nullptr),
     m_codeEditor(nullptr),
     m_completers(),
     m_highlighters(),
@@ -145,6 +146,7 @@ void MainWindow::createWidgets()
     m_tabReplaceEnabledCheckbox  = new QCheckBox("Tab Replace", setupGroup);
     m_tabReplaceNumberSpinbox    = new QSpinBox(setupGroup);
     m_autoIndentationCheckbox    = new QCheckBox("Auto Indentation", setupGroup);
+    m_rainbowParenthesesCheckbox = new QCheckBox("Rainbow Parentheses", setupGroup);
 
 
     // Adding widgets
@@ -162,6 +164,7 @@ void MainWindow::createWidgets()
     m_setupLayout->addWidget(m_tabReplaceEnabledCheckbox);
     m_setupLayout->addWidget(m_tabReplaceNumberSpinbox);
     m_setupLayout->addWidget(m_autoIndentationCheckbox);
+    m_setupLayout->addWidget(m_rainbowParenthesesCheckbox);
     m_setupLayout->addSpacerItem(new QSpacerItem(1, 2, QSizePolicy::Minimum, QSizePolicy::Expanding));
 }
 
@@ -217,6 +220,7 @@ void MainWindow::setupWidgets()
     m_tabReplaceNumberSpinbox->setValue(m_codeEditor->tabReplaceSize());
     m_tabReplaceNumberSpinbox->setSuffix(tr(" spaces"));
     m_autoIndentationCheckbox->setChecked(m_codeEditor->autoIndentation());
+    m_rainbowParenthesesCheckbox->setChecked(m_codeEditor->rainbowParentheses());
 
     m_wordWrapCheckBox->setChecked(m_codeEditor->wordWrapMode() != QTextOption::NoWrap);
 
@@ -302,4 +306,11 @@ void MainWindow::performConnections()
         [this](int state)
         { m_codeEditor->setAutoIndentation(state != 0); }
     );
+
+    connect(
+        m_rainbowParenthesesCheckbox,
+        &QCheckBox::stateChanged,
+        [this](int state)
+        { m_codeEditor->setRainbowParentheses(state != 0); }
+    );
 }
@@ -0,0 +1,216 @@
+#pragma once
+
+// Qt
+#include <QtGlobal>
+#include <QPair>
+#include <QChar>
+
+class QTextBlock;
+class QTextDocument;
+class QSyntaxBlockData;
+class QStyleSyntaxHighlighter;
+
+/**
+ * @brief Class, that describes index of brackets
+ * over document blocks. It's a balanced tree (treap)
+ * with one node per block in document order. Every
+ * node keeps summary of it's subtree, so bracket
+ * queries don't require text scanning.
+ */
+class QBracketIndex
+{
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    QBracketIndex();
+
+    // Disable copying
+    QBracketIndex(const QBracketIndex&) = delete;
+    QBracketIndex& operator=(const QBracketIndex&) = delete;
+
+    /**
+     * @brief Method for getting number of indexed blocks.
+     */
+    int blockCount() const;
+
+    /**
+     * @brief Method for checking is every block of
+     * document indexed. Index can be incomplete before
+     * first highlighting pass is finished.
+     * @param document Pointer to indexed document.
+     */
+    bool isComplete(const QTextDocument* document) const;
+
+    /**
+     * @brief Method for getting bracket depth at block
+     * start.
+     * @param block Indexed block.
+     * @return Depth or 0 if block is not indexed.
+     */
+    int depthAt(const QTextBlock& block) const;
+
+    /**
+     * @brief Method for searching bracket, that matches
+     * bracket at provided position. Brackets are matched
+     * by depth, so result may be a bracket of another
+     * type if brackets are mismatched.
+     * @param block Block, that contains bracket.
+     * @param positionInBlock Bracket position in block.
+     * @param blockLimit Maximum distance in blocks between
+     * brackets. 0 means unlimited.
+     * @return Position of matching bracket in document or -1.
+     */
+    int findMatchingBracket(const QTextBlock& block,
+                            int positionInBlock,
+                            int blockLimit=0) const;
+
+    /**
+     * @brief Method for searching brackets, that enclose
+     * provided position.
+     * @param block Block, that contains position.
+     * @param positionInBlock Position in block.
+     * @return Positions of opening and closing brackets
+     * in document. Position is -1 if bracket is not found.
+     */
+    QPair<int, int> findEnclosingBrackets(const QTextBlock& block,
+                                          int positionInBlock) const;
+
+private:
+    friend class QSyntaxBlockData;
+    friend class QStyleSyntaxHighlighter;
+
+    /**
+     * @brief Method for getting block data of indexed block.
+     * @return Pointer to block data or nullptr if block
+     * doesn't belong to this index.
+     */
+    const QSyntaxBlockData* blockData(const QTextBlock& block) const;
+
+    /**
+     * @brief Method for getting index of first bracket
+     * in block, that's not before position.
+     */
+    int bracketIndex(const QSyntaxBlockData* data, int positionInBlock) const;
+
+    /**
+     * @brief Method for getting depth before bracket
+     * with index, relative to block start.
+     */
+    int relativeDepth(const QSyntaxBlockData* data, int index) const;
+
+    /**
+     * @brief Static method for getting depth change
+     * of bracket.
+     */
+    static int depthStep(QChar bracket);
+
+    /**
+     * @brief Method for searching first bracket after
+     * which depth becomes `target`.
+     * @param first Index of first bracket in block to check.
+     * @return Position in document or -1.
+     */
+    int searchForward(const QTextBlock& block,
+                      const QSyntaxBlockData* data,
+                      int first,
+                      int target,
+                      int blockLimit) const;
+
+    /**
+     * @brief Method for searching last bracket before
+     * which depth is `target`.
+     * @param last Index of bracket in block to start
+     * before.
+     * @return Position in document or -1.
+     */
+    int searchBackward(const QTextBlock& block,
+                       const QSyntaxBlockData* data,
+                       int last,
+                       int target,
+                       int blockLimit) const;
+
+    /**
+     * @brief Method for converting position in indexed
+     * block to position in document.
+     * @return Position or -1 if block is further than
+     * `blockLimit` from `origin`.
+     */
+    int blockPosition(const QTextBlock& origin,
+                      const QSyntaxBlockData* data,
+                      int blockLimit,
+                      int positionInBlock) const;
+
+    /**
+     * @brief Method for inserting block into index.
+     * @param data Block data.
+     * @param previous Data of previous block. nullptr
+     * for first block.
+     */
+    void insert(QSyntaxBlockData* data, QSyntaxBlockData* previous);
+
+    /**
+     * @brief Method for removing block from index.
+     */
+    void remove(QSyntaxBlockData* data);
+
+    /**
+     * @brief Method for updating index after block
+     * brackets change.
+     */
+    void update(QSyntaxBlockData* data);
+
+    /**
+     * @brief Method for getting depth at block start.
+     */
+    int depthBefore(const QSyntaxBlockData* data) const;
+
+    /**
+     * @brief Method for getting number of block.
+     */
+    int blockNumber(const QSyntaxBlockData* data) const;
+
+    /**
+     * @brief Method for searching first block after
+     * `data`, where depth goes down to `target`.
+     * @param depth Depth at the end of `data`.
+     * @param startDepth Depth at start of found block.
+     */
+    const QSyntaxBlockData* findNext(const QSyntaxBlockData* data,
+                                     int depth,
+                                     int target,
+                                     int* startDepth) const;
+
+    /**
+     * @brief Method for searching last block before
+     * `data`, where depth goes down to `target`.
+     * @param depth Depth at the start of `data`.
+     * @param startDepth Depth at start of found block.
+     */
+    const QSyntaxBlockData* findPrevious(const QSyntaxBlockData* data,
+                                         int depth,
+                                         int target,
+                                         int* startDepth) const;
+
+    const QSyntaxBlockData* descendFirst(const QSyntaxBlockData* node,
+                                         int depth,
+                                         int target,
+                                         int* startDepth) const;
+
+    const QSyntaxBlockData* descendLast(const QSyntaxBlockData* node,
+                                        int depth,
+                                        int target,
+                                        int* startDepth) const;
+
+    void pull(QSyntaxBlockData* node);
+
+    void pullUp(QSyntaxBlockData* node);
+
+    void rotateUp(QSyntaxBlockData* node);
+
+    quint32 nextPriority();
+
+    QSyntaxBlockData* m_root;
+    quint32 m_seed;
+};
@@ -26,7 +26,7 @@ public:
     explicit QCXXHighlighter(QTextDocument* document=nullptr);
 
 protected:
-    void highlightBlock(const QString& text) override;
+    void highlightSyntax(const QString& text) override;
 
 private:
 
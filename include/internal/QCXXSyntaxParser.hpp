@@ -0,0 +1,211 @@
+#pragma once
+
+// QCodeEditor
+#include <QSyntaxParser> // Required for inheritance
+
+// Qt
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QTextBlock;
+class QTextDocument;
+
+/**
+ * @brief Class, that describes incremental C++ parser.
+ * It keeps tokens of every block relative to block start,
+ * so edits don't shift tokens of other blocks. Edited
+ * blocks are relexed and following blocks are relexed
+ * only until lexer state (block comment or raw string)
+ * at block end matches previous state again. Bracket
+ * depths of blocks are summarized in segment tree, so
+ * bracket queries don't walk blocks.
+ */
+class QCXXSyntaxParser : public QSyntaxParser
+{
+public:
+
+    /**
+     * @brief Constructor. Keywords are taken from
+     * C++ language description.
+     */
+    QCXXSyntaxParser();
+
+    // Disable copying
+    QCXXSyntaxParser(const QCXXSyntaxParser&) = delete;
+    QCXXSyntaxParser& operator=(const QCXXSyntaxParser&) = delete;
+
+    void reset(const QTextDocument* document) override;
+
+    QPair<int, int> edit(const QTextDocument* document,
+                         int position,
+                         int charsRemoved,
+                         int charsAdded) override;
+
+    QVector<Span> spans(int start, int end) const override;
+
+    /**
+     * @brief Method for getting the smallest bracket pair,
+     * that starts before range and ends at or after it.
+     */
+    QPair<int, int> parentNode(int start, int end) const override;
+
+    /**
+     * @brief Method for getting number of blocks, that
+     * were lexed by the last `reset` or `edit`.
+     */
+    int lexedBlocks() const;
+
+private:
+
+    /**
+     * @brief Structure, that describes lexed token.
+     * Position is relative to block start. Brackets
+     * have no format, they're kept for tree.
+     */
+    struct Token
+    {
+        int start;
+        int length;
+        int format;
+    };
+
+    /**
+     * @brief Structure, that describes lexer state
+     * at block end.
+     */
+    struct State
+    {
+        // Block ends inside block comment
+        bool comment;
+
+        // Closing sequence of raw string, that block
+        // ends inside (e.g. `)x"`), or empty string
+        QString rawString;
+
+        bool operator==(const State& other) const;
+    };
+
+    /**
+     * @brief Structure, that describes lexed block.
+     */
+    struct Line
+    {
+        QVector<Token> tokens;
+        State state;
+
+        // Bracket depth change of block and the
+        // lowest depth in it relative to block start
+        int depthDelta;
+        int minimumDepth;
+    };
+
+    /**
+     * @brief Structure, that describes bracket depth
+     * change of range of blocks and the lowest depth
+     * in it relative to range start.
+     */
+    struct Summary
+    {
+        int delta;
+        int minimum;
+    };
+
+    /**
+     * @brief Method for lexing block text.
+     * @param text Block text.
+     * @param state State at the end of previous block.
+     */
+    Line lexBlock(const QString& text, const State& state) const;
+
+    /**
+     * @brief Method for searching the first bracket
+     * after (forward) or the last bracket before
+     * (backward) position, where depth goes down to
+     * `target`.
+     * @param depth Depth at position.
+     * @return Bracket position or -1.
+     */
+    int findBracket(int position, int depth, int target, bool forward) const;
+
+    /**
+     * @brief Method for searching bracket, where depth
+     * goes down to `target`, in block.
+     * @param depth Depth at position. It's updated
+     * with passed brackets.
+     * @return Bracket position or -1.
+     */
+    int scanBlock(const QTextBlock& block,
+                  int position,
+                  bool forward,
+                  int* depth,
+                  int target) const;
+
+    /**
+     * @brief Method for updating depth with brackets
+     * of block in range [first, last).
+     * @return The lowest depth in range.
+     */
+    int scanDepth(const QTextBlock& block, int first, int last, int* depth) const;
+
+    /**
+     * @brief Method for getting depth at block start.
+     */
+    int depthBefore(int line) const;
+
+    /**
+     * @brief Method for searching first block after
+     * `line`, where depth goes down to `target`.
+     * @param depth Depth at the end of `line`.
+     * @param startDepth Depth at start of found block.
+     * @return Block number or -1.
+     */
+    int findNextLine(int line, int depth, int target, int* startDepth) const;
+
+    /**
+     * @brief Method for searching last block before
+     * `line`, where depth goes down to `target`.
+     * @param depth Depth at the start of `line`.
+     * @param startDepth Depth at start of found block.
+     * @return Block number or -1.
+     */
+    int findPreviousLine(int line, int depth, int target, int* startDepth) const;
+
+    /**
+     * @brief Method for getting summary of blocks
+     * in range [first, last).
+     */
+    Summary rangeSummary(int first, int last) const;
+
+    /**
+     * @brief Method for rebuilding summaries of
+     * all blocks.
+     */
+    void buildSummaries();
+
+    /**
+     * @brief Method for updating summaries of blocks
+     * in range [first, last).
+     */
+    void updateSummaries(int first, int last);
+
+    /**
+     * @brief Static method for joining summaries of
+     * adjacent ranges.
+     */
+    static Summary join(const Summary& left, const Summary& right);
+
+    const QTextDocument* m_document;
+
+    QStringList m_formats;
+    QHash<QString, int> m_keywords;
+
+    QVector<Line> m_lines;
+    int m_lexedBlocks;
+
+    // Segment tree of block summaries, leaves are
+    // stored from `m_leafCount`
+    QVector<Summary> m_summaries;
+    int m_leafCount;
+};
@@ -1,13 +1,25 @@
 #pragma once
 
+// QCodeEditor
+#include <QSyntaxBlockData>
+#include <QDiagnosticIndex>
+#include <QInlineHintIndex>
+#include <QWordIndex>
+
 // Qt
 #include <QTextEdit> // Required for inheritance
+#include <QCache>
+#include <QHash>
+#include <QElapsedTimer>
 
 class QCompleter;
 class QLineNumberArea;
 class QSyntaxStyle;
 class QStyleSyntaxHighlighter;
 class QFramedTextAttribute;
+class QHoverProvider;
+class QTimer;
+class QTracer;
 
 /**
  * @brief Class, that describes code editor.
@@ -17,6 +29,40 @@ class QCodeEditor : public QTextEdit
     Q_OBJECT
 
 public:
+
+    /**
+     * @brief Policy of joining typed keystrokes
+     * into undo steps.
+     */
+    enum class UndoCoalescing
+    {
+        // QTextDocument merging, every edit block is a step
+        EditBlock,
+
+        // Typed word with following separators is a step
+        Word,
+
+        // Keystrokes within time window from the first
+        // keystroke of step are a step
+        TimeWindow
+    };
+
+    /**
+     * @brief Structure, that describes changes
+     * made by whitespace cleanup.
+     */
+    struct CleanupResult
+    {
+        // Lines with removed trailing whitespaces
+        int trimmedLines;
+
+        // Lines with converted indentation
+        int reindentedLines;
+
+        // Line break was added at document end
+        bool finalNewlineAdded;
+    };
+
     /**
      * @brief Constructor.
      * @param widget Pointer to parent widget.
@@ -94,6 +140,35 @@ public:
      */
     bool autoIndentation() const;
 
+    /**
+     * @brief Method for setting coloring of parentheses
+     * by nesting depth. It's performed by highlighter
+     * with "Parentheses1".."ParenthesesN" style formats.
+     */
+    void setRainbowParentheses(bool enabled);
+
+    /**
+     * @brief Method for getting is rainbow parentheses
+     * enabled.
+     * Default: false
+     */
+    bool rainbowParentheses() const;
+
+    /**
+     * @brief Method for setting maximal distance in
+     * blocks between matching parentheses. Parentheses
+     * further away are not highlighted.
+     * @param blocks Number of blocks. 0 means unlimited.
+     */
+    void setParenthesesSearchLimit(int blocks);
+
+    /**
+     * @brief Method for getting maximal distance in
+     * blocks between matching parentheses.
+     * Default: 0 (unlimited)
+     */
+    int parenthesesSearchLimit() const;
+
     /**
      * @brief Method for setting completer.
      * @param completer Pointer to completer object.
@@ -106,6 +181,230 @@ public:
      */
     QCompleter* completer() const;
 
+    /**
+     * @brief Method for replacing diagnostics. They are
+     * shifted with edits and drawn with "Error", "Warning"
+     * and "Information" style formats for visible lines.
+     * Document is not rehighlighted.
+     * @param diagnostics Diagnostics in any order.
+     */
+    void setDiagnostics(QVector<QDiagnostic> diagnostics);
+
+    /**
+     * @brief Method for removing all diagnostics.
+     */
+    void clearDiagnostics();
+
+    /**
+     * @brief Method for getting diagnostics with
+     * positions updated by edits.
+     */
+    QVector<QDiagnostic> diagnostics() const;
+
+    /**
+     * @brief Method for replacing inline hints. Hints
+     * are drawn with "InlineHint" style format in space,
+     * that's reserved by highlighter. Document isn't
+     * modified. Requires highlighter. Space is reserved
+     * after previous character, so hints at start of
+     * non empty blocks aren't drawn. They're kept and
+     * shifted by edits like other hints.
+     * @param hints Hints in any order.
+     */
+    void setInlineHints(QVector<QInlineHint> hints);
+
+    /**
+     * @brief Method for removing all inline hints.
+     */
+    void clearInlineHints();
+
+    /**
+     * @brief Method for getting inline hints with
+     * positions updated by edits.
+     */
+    QVector<QInlineHint> inlineHints() const;
+
+    /**
+     * @brief Method for setting hover information
+     * provider. Answers are cached per block revision
+     * and word, answers for changed text are dropped.
+     * Diagnostic messages are shown with hover, if
+     * provider is set. Provider is not owned by editor.
+     * @param provider Pointer to provider. May be nullptr.
+     */
+    void setHoverProvider(QHoverProvider* provider);
+
+    /**
+     * @brief Method for getting hover information
+     * provider.
+     * @return Pointer to provider. May be nullptr.
+     */
+    QHoverProvider* hoverProvider() const;
+
+    /**
+     * @brief Method for setting delay between mouse
+     * stop and hover request.
+     * @param msec Delay in milliseconds.
+     */
+    void setHoverDelay(int msec);
+
+    /**
+     * @brief Method for getting hover delay.
+     * Default: 500
+     */
+    int hoverDelay() const;
+
+    /**
+     * @brief Method for setting recorder of tracing
+     * spans. Key press phases, highlighting, extra
+     * selections and painting are recorded, also
+     * latency from key press to paint. Tracer is
+     * not owned by editor.
+     * @param tracer Pointer to tracer. If nullptr,
+     * tracing is disabled.
+     */
+    void setTracer(QTracer* tracer);
+
+    /**
+     * @brief Method for getting recorder of tracing
+     * spans.
+     * @return Pointer to tracer. May be nullptr.
+     */
+    QTracer* tracer() const;
+
+    /**
+     * @brief Method for setting size of pasted text,
+     * that is inserted without highlighting. Such text
+     * gets line endings normalized and is highlighted
+     * in background after insertion.
+     * @param size Number of characters.
+     */
+    void setLargePasteSize(int size);
+
+    /**
+     * @brief Method for getting size of large paste.
+     * Default: 1048576
+     */
+    int largePasteSize() const;
+
+    /**
+     * @brief Method for setting policy of joining
+     * keystrokes into undo steps. Steps are joined
+     * only if nothing else changed document or moved
+     * cursor between keystrokes.
+     */
+    void setUndoCoalescing(UndoCoalescing coalescing);
+
+    /**
+     * @brief Method for getting undo coalescing policy.
+     * Default: EditBlock
+     */
+    UndoCoalescing undoCoalescing() const;
+
+    /**
+     * @brief Method for setting time window of
+     * `UndoCoalescing::TimeWindow` policy.
+     * @param msec Maximal time between the first and
+     * the last keystroke of step in milliseconds.
+     */
+    void setUndoTimeWindow(int msec);
+
+    /**
+     * @brief Method for getting undo time window.
+     * Default: 1000
+     */
+    int undoTimeWindow() const;
+
+    /**
+     * @brief Method for setting limit of undo memory
+     * usage. Usage is estimated by text, that's added
+     * by edits, format changes aren't counted.
+     * Limitation: QTextDocument owns undo steps and has
+     * no API for removing the oldest of them, so the
+     * whole undo history is cleared, when it exceeds
+     * limit. Redo history is kept.
+     * @param bytes Limit in bytes. 0 disables limit.
+     */
+    void setUndoMemoryLimit(qint64 bytes);
+
+    /**
+     * @brief Method for getting undo memory limit.
+     * Default: 0
+     */
+    qint64 undoMemoryLimit() const;
+
+    /**
+     * @brief Method for getting estimated memory
+     * usage of undo history. It counts inserted
+     * text, which document keeps for undo, and
+     * undo commands of steps, that can be undone.
+     * Undo and redo don't add to usage.
+     * @return Estimation in bytes.
+     */
+    qint64 undoMemoryUsage() const;
+
+    /**
+     * @brief Method for checking is there rectangular
+     * selection. It's made by mouse with Alt modifier.
+     */
+    bool hasBoxSelection() const;
+
+    /**
+     * @brief Method for getting text of rectangular
+     * selection.
+     * @return Selected part of every line, joined with
+     * line breaks.
+     */
+    QString boxSelectedText() const;
+
+    /**
+     * @brief Method for setting snippets, that are
+     * expanded by completion. Snippet text may have
+     * tab stops `$1`, placeholders `${1:text}` and
+     * final cursor position `$0`, see `QSnippet`.
+     * @param snippets Snippets by completion text.
+     */
+    void setSnippets(const QHash<QString, QString>& snippets);
+
+    /**
+     * @brief Method for getting snippets, that are
+     * expanded by completion.
+     */
+    const QHash<QString, QString>& snippets() const;
+
+    /**
+     * @brief Method for checking is there inserted
+     * snippet with tab stops, that are navigated
+     * by Tab and Backtab.
+     */
+    bool hasActiveSnippet() const;
+
+    /**
+     * @brief Method for cleaning up whitespaces before
+     * saving. It removes trailing whitespaces, converts
+     * indentation to spaces or tabs by `tabReplace` and
+     * adds line break at document end. Only changed lines
+     * are edited, all edits are one undo step.
+     * @return Numbers of changed lines.
+     */
+    CleanupResult cleanupWhitespace();
+
+    /**
+     * @brief Method for setting completion of document
+     * words. Words are indexed incrementally by changed
+     * blocks and ranked by frequency and distance to
+     * cursor. Completer model has to be
+     * `QCompletionListModel`.
+     */
+    void setWordCompletion(bool enabled);
+
+    /**
+     * @brief Method for getting is completion of
+     * document words enabled.
+     * Default: false
+     */
+    bool wordCompletion() const;
+
 public Q_SLOTS:
 
     /**
@@ -146,6 +445,125 @@ public Q_SLOTS:
      */
     void onSelectionChanged();
 
+    /**
+     * @brief Slot, that moves cursor to parenthesis,
+     * that encloses cursor position. Requires highlighter.
+     */
+    void jumpToEnclosingParenthesis();
+
+    /**
+     * @brief Slot, that selects block between enclosing
+     * parentheses including them. Every next call extends
+     * selection to outer block. Requires highlighter.
+     */
+    void selectEnclosingBlock();
+
+    /**
+     * @brief Slot, that expands selection to the next
+     * syntax node: word, string, list item, bracket
+     * contents, brackets, lines, indentation block
+     * and document.
+     */
+    void expandSelection();
+
+    /**
+     * @brief Slot, that restores selection, that was
+     * before last `expandSelection` call.
+     */
+    void shrinkSelection();
+
+    /**
+     * @brief Slot, that indents lines covered by
+     * selection as one edit. Empty lines are skipped.
+     */
+    void indentSelection();
+
+    /**
+     * @brief Slot, that removes one indentation level
+     * from lines covered by selection as one edit.
+     */
+    void unindentSelection();
+
+    /**
+     * @brief Slot, that reindents document by structure
+     * of highlighter as one edit. Requires highlighter.
+     * Lines inside multiline strings and comments are kept.
+     */
+    void reindent();
+
+    /**
+     * @brief Slot, that removes rectangular selection
+     * without changing text.
+     */
+    void clearBoxSelection();
+
+    /**
+     * @brief Slots, that move lines covered by
+     * selection above previous line or below
+     * next line.
+     */
+    void moveLinesUp();
+    void moveLinesDown();
+
+    /**
+     * @brief Slot, that inserts copy of lines covered
+     * by selection below them and selects the copy.
+     */
+    void duplicateLines();
+
+    /**
+     * @brief Slot, that sorts lines covered by
+     * selection. Big selections are sorted by
+     * several threads.
+     */
+    void sortLines();
+
+    /**
+     * @brief Slot, that joins lines covered by selection
+     * with single spaces. Without multiline selection
+     * current line is joined with next one.
+     */
+    void joinLines();
+
+    /**
+     * @brief Slot, that removes lines covered
+     * by selection.
+     */
+    void deleteLines();
+
+    /**
+     * @brief Slot, that comments or uncomments lines
+     * covered by selection as one edit. Tokens are taken
+     * from highlighter, line comments are preferred.
+     * Lines are uncommented, if all of them are commented.
+     * Requires highlighter.
+     */
+    void toggleComment();
+
+    /**
+     * @brief Slot, that inserts snippet instead of
+     * selection and selects it's first tab stop.
+     * Following lines get indentation of current line.
+     * @param snippet Snippet text.
+     */
+    void insertSnippet(const QString& snippet);
+
+    /**
+     * @brief Slot, that stops tab stop navigation
+     * of inserted snippet without changing text.
+     */
+    void clearSnippet();
+
+Q_SIGNALS:
+
+    /**
+     * @brief Signal, that's emitted while `reindent`
+     * applies indentation.
+     * @param value Number of processed lines.
+     * @param maximum Number of lines.
+     */
+    void reindentProgress(int value, int maximum);
+
 protected:
     /**
      * @brief Method, that's called on any text insertion of
@@ -185,6 +603,27 @@ protected:
      */
     void focusInEvent(QFocusEvent *e) override;
 
+    /**
+     * @brief Method, that's called on any viewport event.
+     * It's overloaded for showing diagnostic message
+     * tooltip.
+     */
+    bool viewportEvent(QEvent* event) override;
+
+    /**
+     * @brief Method, that's called on mouse move.
+     * It's overloaded for hover delay.
+     */
+    void mouseMoveEvent(QMouseEvent* e) override;
+
+    /**
+     * @brief Methods, that are called on mouse press
+     * and release. They're overloaded for rectangular
+     * selection with Alt modifier.
+     */
+    void mousePressEvent(QMouseEvent* e) override;
+    void mouseReleaseEvent(QMouseEvent* e) override;
+
 private:
 
     /**
@@ -216,6 +655,12 @@ private:
      */
     void updateLineGeometry();
 
+    /**
+     * @brief Method for highlighting part of blocks,
+     * which highlighting was deferred by large paste.
+     */
+    void highlightPendingBlocks();
+
     /**
      * @brief Method, that performs completer processing.
      * Returns true if event has to be dropped.
@@ -225,6 +670,127 @@ private:
     bool proceedCompleterBegin(QKeyEvent *e);
     void proceedCompleterEnd(QKeyEvent* e);
 
+    /**
+     * @brief Method, that performs key press processing
+     * with auto indentation and auto parentheses.
+     * @param e Pointer to key event.
+     * @return Has completer to be processed.
+     */
+    bool proceedKeyPress(QKeyEvent* e);
+
+    /**
+     * @brief Kind of keystroke for undo coalescing.
+     */
+    enum class UndoStepKind
+    {
+        None,
+        Word,
+        Separator,
+        Deletion
+    };
+
+    /**
+     * @brief Method for getting undo kind of keystroke.
+     * Keystrokes of None kind don't change undo steps.
+     */
+    UndoStepKind undoStepKind(QKeyEvent* e) const;
+
+    /**
+     * @brief Method for starting undo step of keystroke.
+     * It joins previous step, if coalescing policy allows.
+     */
+    void beginUndoStep(QTextCursor& cursor, UndoStepKind kind);
+
+    /**
+     * @brief Method for finishing undo step of keystroke.
+     */
+    void endUndoStep(QTextCursor& cursor, UndoStepKind kind);
+
+    /**
+     * @brief Method for clearing undo history, if it
+     * exceeds memory limit.
+     */
+    void applyUndoMemoryLimit();
+
+    /**
+     * @brief Method for updating undo memory usage after
+     * document change. New commands add their size to the
+     * top undo step, undo and redo only move between
+     * steps, that are already counted.
+     * @param bytes Estimated size of change.
+     */
+    void updateUndoMemoryUsage(qint64 bytes);
+
+    /**
+     * @brief Method, that performs key press processing
+     * for rectangular selection.
+     * @param e Pointer to key event.
+     * @return Was event processed.
+     */
+    bool proceedBoxSelection(QKeyEvent* e);
+
+    /**
+     * @brief Method for replacing selected columns of
+     * every line of rectangular selection in one edit.
+     * Short lines are padded with spaces. Selection is
+     * collapsed after replaced text.
+     * @param first First column to replace.
+     * @param last Column after last replaced one.
+     * @param lines Text for every line. If there is one
+     * text, it's used for all lines.
+     */
+    void replaceBoxText(int first, int last, const QStringList& lines);
+
+    /**
+     * @brief Method for getting column of point in
+     * monospace characters.
+     * @param block Block at point.
+     * @param x Horizontal viewport coordinate.
+     */
+    int columnAt(const QTextBlock& block, int x) const;
+
+    /**
+     * @brief Method for painting visible part of
+     * rectangular selection.
+     */
+    void paintBoxSelection();
+
+    /**
+     * @brief Method, that performs key press processing
+     * for tab stops of inserted snippet. Tab and Backtab
+     * move between tab stops while cursor is inside of
+     * snippet, otherwise snippet is cleared.
+     * @param e Pointer to key event.
+     * @return Was event processed.
+     */
+    bool proceedSnippet(QKeyEvent* e);
+
+    /**
+     * @brief Method for selecting tab stop of snippet.
+     * @param index Index of tab stop number.
+     */
+    void selectSnippetStop(int index);
+
+    /**
+     * @brief Method for copying text of current tab stop
+     * to tab stops with the same number.
+     */
+    void updateSnippetMirrors();
+
+    /**
+     * @brief Method, that performs auto parentheses
+     * processing instead of QTextEdit. Typed character
+     * with closing one is inserted as one edit, typed
+     * closing character is stepped over without edit.
+     * @param e Pointer to key event.
+     * @param token Token under cursor before key press.
+     * @param positionInBlock Cursor position before key press.
+     * @return Was event processed.
+     */
+    bool proceedAutoParentheses(QKeyEvent* e,
+                                const QSyntaxBlockData::TokenSpan& token,
+                                int positionInBlock);
+
     /**
      * @brief Method for getting character under
      * cursor.
@@ -232,6 +798,111 @@ private:
      */
     QChar charUnderCursor(int offset = 0) const;
 
+    /**
+     * @brief Method for getting first and last blocks,
+     * covered by cursor selection. Last block isn't
+     * covered if selection ends at it's start.
+     */
+    QPair<QTextBlock, QTextBlock> selectedBlocks(const QTextCursor& cursor) const;
+
+    /**
+     * @brief Method for selecting whole blocks with
+     * direction of current selection.
+     */
+    void selectBlocks(const QTextBlock& first, const QTextBlock& last);
+
+    /**
+     * @brief Method for getting text of blocks.
+     */
+    QStringList blocksText(const QTextBlock& first, const QTextBlock& last) const;
+
+    /**
+     * @brief Method for replacing text of blocks as
+     * one edit. Big text is highlighted in background.
+     * @param text New text without last line break.
+     * @param anchor Selection anchor after replacing.
+     * @param position Cursor position after replacing.
+     */
+    void replaceBlocks(const QTextBlock& first,
+                       const QTextBlock& last,
+                       const QString& text,
+                       int anchor,
+                       int position);
+
+    /**
+     * @brief Method for getting string or comment token,
+     * that contains cursor. Token is taken from highlighter
+     * block data, so text is not scanned.
+     * @return Token span in cursor block. Span has Code
+     * type if cursor is outside of strings and comments
+     * or there is no highlighter.
+     */
+    QSyntaxBlockData::TokenSpan tokenSpanUnderCursor() const;
+
+    /**
+     * @brief Method for highlighting diagnostics
+     * of visible blocks.
+     */
+    void highlightDiagnostics(QList<QTextEdit::ExtraSelection>& extraSelection);
+
+    /**
+     * @brief Method for getting messages of diagnostics
+     * under viewport point.
+     * @return Messages separated by new lines.
+     */
+    QString diagnosticMessage(const QPoint& point) const;
+
+    /**
+     * @brief Method for rehighlighting blocks with
+     * hints, so highlighter updates reserved space.
+     * @param hints Hints ordered by position.
+     */
+    void rehighlightInlineHints(const QVector<QInlineHint>& hints);
+
+    /**
+     * @brief Method for drawing inline hints of
+     * visible blocks.
+     */
+    void paintInlineHints();
+
+    /**
+     * @brief Method, that's called after hover delay.
+     * It shows cached hover or requests it from provider.
+     */
+    void requestHover();
+
+    /**
+     * @brief Method, that's called on provider answer.
+     */
+    void onHoverReady(int requestId, QString text);
+
+    /**
+     * @brief Method for cancelling pending hover
+     * request.
+     */
+    void cancelHover();
+
+    /**
+     * @brief Method for showing hover tooltip with
+     * diagnostic message of pending request.
+     * @param text Hover text.
+     */
+    void showHover(const QString& text);
+
+    /**
+     * @brief Structure, that describes pending
+     * hover request.
+     */
+    struct HoverRequest
+    {
+        int id;
+        QString key;
+        int blockNumber;
+        int revision;
+        QRect rect;
+        QString message;
+    };
+
     /**
      * @brief Method for getting word under
      * cursor.
@@ -251,6 +922,38 @@ private:
      */
     void highlightParenthesis(QList<QTextEdit::ExtraSelection>& extraSelection);
 
+    /**
+     * @brief Method for searching parenthesis, that
+     * matches parenthesis at position. It uses bracket
+     * index of highlighter if it's available.
+     * @param position Position of parenthesis.
+     * @return Position of matching parenthesis or -1.
+     */
+    int findMatchingParenthesis(int position) const;
+
+    /**
+     * @brief Method for searching parentheses, that
+     * enclose position.
+     * @return Positions of opening and closing parentheses.
+     * Position is -1 if it's not found or there is no
+     * bracket index.
+     */
+    QPair<int, int> findEnclosingParentheses(int position) const;
+
+    /**
+     * @brief Method for highlighting name of tag
+     * under cursor and it's pair. Requires highlighter
+     * with element index.
+     */
+    void highlightMatchingTag(QList<QTextEdit::ExtraSelection>& extraSelection);
+
+    /**
+     * @brief Method for getting tag name range.
+     * @param position Position of tag start.
+     * @return Range [start, end) of name.
+     */
+    QPair<int, int> findTagName(int position) const;
+
     /**
      * @brief Method for getting number of indentation
      * spaces in current line. Tabs will be treated
@@ -269,5 +972,91 @@ private:
     bool m_autoParentheses;
     bool m_replaceTab;
     QString m_tabReplace;
+    int m_parenthesesSearchLimit;
+    bool m_rainbowParentheses;
+
+    QVector<QPair<int, int>> m_selectionHistory;
+
+    QDiagnosticIndex m_diagnostics;
+    QInlineHintIndex m_inlineHints;
+
+    QHoverProvider* m_hoverProvider;
+    QTimer* m_hoverTimer;
+    int m_hoverDelay;
+    QPoint m_hoverPoint;
+    int m_hoverRequestCounter;
+    HoverRequest m_hoverRequest;
+    QCache<QString, QString> m_hoverCache;
+
+    int m_largePasteSize;
+    QTimer* m_highlightTimer;
+
+    UndoCoalescing m_undoCoalescing;
+    int m_undoTimeWindow;
+    qint64 m_undoMemoryLimit;
+    qint64 m_undoMemoryUsage;
+    bool m_undoLimitPending;
+
+    // Estimated size of every undo and redo step and
+    // number of steps, that are counted by usage
+    QVector<qint64> m_undoStepSizes;
+    int m_undoStepCount;
+    bool m_undoCommandAdded;
+
+    // Document revision of the last contents change
+    int m_contentsRevision;
+
+    // Last keystroke step, that may be joined.
+    // Timer is started by the first keystroke of step
+    UndoStepKind m_undoKind;
+    int m_undoSteps;
+    int m_undoPosition;
+    QElapsedTimer m_undoTimer;
+
+    /**
+     * @brief Structure, that describes rectangular
+     * selection as block numbers and columns.
+     * Selection is empty, if anchor block is -1.
+     */
+    struct BoxSelection
+    {
+        int anchorBlock;
+        int anchorColumn;
+        int block;
+        int column;
+    };
+
+    BoxSelection m_boxSelection;
+    bool m_boxDragging;
+    bool m_boxEditing;
+
+    bool m_wordCompletion;
+    QWordIndex m_wordIndex;
+
+    /**
+     * @brief Structure, that describes tab stop of
+     * inserted snippet. Range is kept by cursors, so
+     * it's moved by document edits without rescanning.
+     * Start cursors of current tab stop stay before
+     * text typed at them.
+     */
+    struct SnippetStop
+    {
+        int number;
+        QTextCursor start;
+        QTextCursor end;
+    };
+
+    QHash<QString, QString> m_snippets;
+    QVector<SnippetStop> m_snippetStops;
+
+    // Tab stop numbers in navigation order
+    QVector<int> m_snippetNumbers;
+    int m_snippetIndex;
+    QTextCursor m_snippetStart;
+    QTextCursor m_snippetEnd;
+
+    QTracer* m_tracer;
+    qint64 m_keystrokeStart;
 };
 
@@ -0,0 +1,131 @@
+#pragma once
+
+// Qt
+#include <QAbstractListModel> // Required for inheritance
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Class, that describes completion model,
+ * that filters words by itself. QCodeEditor sets
+ * completion prefix and document words to it, so
+ * QCompleter shows rows without filtering.
+ * Words are sorted by precomputed lowercase keys,
+ * so prefix filtering is a binary search for range
+ * of words without copying them.
+ */
+class QCompletionListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param words Completion words, e.g. language keywords.
+     * @param parent Pointer to parent QObject.
+     */
+    explicit QCompletionListModel(const QStringList& words=QStringList(),
+                                  QObject* parent=nullptr);
+
+    // Disable copying
+    QCompletionListModel(const QCompletionListModel&) = delete;
+    QCompletionListModel& operator=(const QCompletionListModel&) = delete;
+
+    /**
+     * @brief Method for setting completion words.
+     * Words are sorted case insensitively, duplicates
+     * are removed. Filter is reset.
+     */
+    void setWords(const QStringList& words);
+
+    /**
+     * @brief Method for getting completion words
+     * in sorted order.
+     */
+    QStringList words() const;
+
+    /**
+     * @brief Method for setting maximum number of
+     * rows. Popup size is computed from all rows,
+     * so short prefixes of big word lists are cut.
+     * @param rows Number of rows. 0 disables limit.
+     */
+    void setMaximumRows(int rows);
+
+    /**
+     * @brief Method for getting maximum number of rows.
+     * Default: 1000
+     */
+    int maximumRows() const;
+
+    /**
+     * @brief Method for setting fuzzy matching. Then
+     * prefix matches words as subsequence and rows
+     * are ranked by `QFuzzyMatcher` score.
+     */
+    void setFuzzyMatching(bool enabled);
+
+    /**
+     * @brief Method for getting is fuzzy matching
+     * enabled.
+     * Default: false
+     */
+    bool fuzzyMatching() const;
+
+    /**
+     * @brief Method for filtering rows by prefix.
+     * Prefix is compared case insensitively. With fuzzy
+     * matching only the best `maximumRows` words are
+     * scored into rows.
+     * @param prefix Completion prefix. Empty prefix
+     * shows all words.
+     * @param documentWords Ranked words from document,
+     * they go before completion words. Completion words
+     * aren't repeated.
+     */
+    void setCompletionPrefix(const QString& prefix,
+                             const QStringList& documentWords=QStringList());
+
+    /**
+     * @brief Method for getting completion prefix.
+     */
+    QString completionPrefix() const;
+
+    int rowCount(const QModelIndex& parent=QModelIndex()) const override;
+
+    QVariant data(const QModelIndex& index, int role=Qt::DisplayRole) const override;
+
+private:
+
+    /**
+     * @brief Method for checking is there
+     * completion word.
+     */
+    bool containsWord(const QString& word) const;
+
+    /**
+     * @brief Method for checking are rows taken
+     * from fuzzy matches.
+     */
+    bool isFuzzy() const;
+
+    // Lowercase keys in sorted order and words with the same index
+    QVector<QString> m_keys;
+    QVector<QString> m_words;
+
+    // Character masks of words for fuzzy prefilter
+    QVector<quint64> m_masks;
+
+    int m_maximumRows;
+    bool m_fuzzyMatching;
+    QString m_prefix;
+    QStringList m_documentWords;
+
+    // Range of words, that match prefix
+    int m_first;
+    int m_last;
+
+    // Indexes of words, that match fuzzy prefix, in rank order
+    QVector<int> m_matches;
+};
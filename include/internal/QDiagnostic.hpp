@@ -0,0 +1,42 @@
+#pragma once
+
+// Qt
+#include <QString>
+
+/**
+ * @brief Structure, that describes diagnostic
+ * message for document range [start, end).
+ */
+struct QDiagnostic
+{
+    /**
+     * @brief Diagnostic severity. Every severity
+     * is drawn with syntax style format of the
+     * same name.
+     */
+    enum class Severity
+    {
+        Error,
+        Warning,
+        Information
+    };
+
+    QDiagnostic() :
+        start(0),
+        end(0),
+        severity(Severity::Error),
+        message()
+    {}
+
+    QDiagnostic(int s, int e, Severity sev, QString m) :
+        start(s),
+        end(e),
+        severity(sev),
+        message(std::move(m))
+    {}
+
+    int start;
+    int end;
+    Severity severity;
+    QString message;
+};
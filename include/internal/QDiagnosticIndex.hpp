@@ -0,0 +1,141 @@
+#pragma once
+
+// QCodeEditor
+#include <QDiagnostic>
+
+// Qt
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * @brief Class, that describes interval tree of
+ * diagnostics. It's a balanced tree (treap) ordered
+ * by diagnostic start. Every node keeps maximal end
+ * of it's subtree and pending shift of it's children,
+ * so edits shift diagnostics in logarithmic time.
+ */
+class QDiagnosticIndex
+{
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    QDiagnosticIndex();
+
+    /**
+     * @brief Destructor.
+     */
+    ~QDiagnosticIndex();
+
+    // Disable copying
+    QDiagnosticIndex(const QDiagnosticIndex&) = delete;
+    QDiagnosticIndex& operator=(const QDiagnosticIndex&) = delete;
+
+    /**
+     * @brief Method for replacing all diagnostics.
+     * @param diagnostics Diagnostics in any order.
+     */
+    void setDiagnostics(QVector<QDiagnostic> diagnostics);
+
+    /**
+     * @brief Method for removing all diagnostics.
+     */
+    void clear();
+
+    /**
+     * @brief Method for getting number of diagnostics.
+     */
+    int size() const;
+
+    /**
+     * @brief Method for shifting diagnostics after
+     * document edit. Diagnostics inside of removed
+     * text are collapsed to edit position.
+     * @param position Edit position.
+     * @param charsRemoved Number of removed characters.
+     * @param charsAdded Number of added characters.
+     */
+    void shift(int position, int charsRemoved, int charsAdded);
+
+    /**
+     * @brief Method for getting diagnostics, that
+     * intersect range [start, end]. Range bounds are
+     * included, so empty diagnostics are found too.
+     * @return Diagnostics ordered by start.
+     */
+    QVector<QDiagnostic> diagnostics(int start, int end) const;
+
+    /**
+     * @brief Method for getting all diagnostics.
+     * @return Diagnostics ordered by start.
+     */
+    QVector<QDiagnostic> diagnostics() const;
+
+private:
+
+    struct Node;
+
+    /**
+     * @brief Method for shifting whole subtree.
+     */
+    static void apply(Node* node, int delta);
+
+    /**
+     * @brief Method for passing pending shift
+     * to children.
+     */
+    static void push(Node* node);
+
+    /**
+     * @brief Method for updating node maximal end
+     * from children.
+     */
+    static void pull(Node* node);
+
+    /**
+     * @brief Method for splitting tree into nodes,
+     * that start before `position`, and other nodes.
+     */
+    static void split(Node* node, int position, Node*& left, Node*& right);
+
+    /**
+     * @brief Method for merging trees. All nodes of
+     * `left` have to start before nodes of `right`.
+     */
+    static Node* merge(Node* left, Node* right);
+
+    /**
+     * @brief Method for collapsing diagnostics, that
+     * start inside of removed text.
+     */
+    static void collapse(Node* node, int position, int removedEnd, int delta);
+
+    /**
+     * @brief Method for updating ends of diagnostics,
+     * that start before edit and end after it.
+     */
+    static void adjustEnds(Node* node, int position, int removedEnd, int delta);
+
+    /**
+     * @brief Method for collecting diagnostics, that
+     * intersect range.
+     * @param offset Pending shift of ancestors.
+     */
+    static void collect(const Node* node,
+                        int offset,
+                        int start,
+                        int end,
+                        QVector<QDiagnostic>& result);
+
+    static void destroy(Node* node);
+
+    /**
+     * @brief Method for generating node priority.
+     */
+    quint32 nextPriority();
+
+    Node* m_root;
+    int m_size;
+    quint32 m_seed;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+// Qt
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Class, that describes fuzzy matcher of
+ * pattern as case insensitive subsequence of words
+ * (e.g. "gfvb" matches "getFirstVisibleBlock").
+ * Words are prefiltered by character masks, so most
+ * of them are rejected without scoring.
+ */
+class QFuzzyMatcher
+{
+public:
+
+    /**
+     * @brief Constructor.
+     * @param pattern Typed pattern.
+     */
+    explicit QFuzzyMatcher(const QString& pattern);
+
+    /**
+     * @brief Method for getting character mask
+     * of pattern.
+     */
+    quint64 mask() const;
+
+    /**
+     * @brief Method for scoring word. Matches at word
+     * start, after `_` and at camel case humps and
+     * consecutive matches score higher.
+     * @param word Word to score.
+     * @return Score or -1, if word doesn't match.
+     */
+    int score(const QString& word) const;
+
+    /**
+     * @brief Method for getting indexes of matching
+     * words. Words are prefiltered by masks and scored
+     * by several threads for big lists.
+     * @param words Words.
+     * @param masks Character masks of words.
+     * @param limit Maximum number of indexes. 0 disables limit.
+     * @return Indexes ordered by score, equal scores are
+     * ordered by index, so ranking is stable.
+     */
+    QVector<int> match(const QVector<QString>& words,
+                       const QVector<quint64>& masks,
+                       int limit) const;
+
+    /**
+     * @brief Static method for getting mask of case
+     * insensitive characters of text. Word can match
+     * pattern only if it's mask contains pattern mask.
+     */
+    static quint64 characterMask(const QString& text);
+
+private:
+
+    /**
+     * @brief Structure, that describes scored word.
+     */
+    struct Match
+    {
+        int score;
+        int index;
+    };
+
+    /**
+     * @brief Method for scoring range of words.
+     */
+    void matchRange(const QVector<QString>& words,
+                    const QVector<quint64>& masks,
+                    int first,
+                    int last,
+                    QVector<Match>& matches) const;
+
+    QString m_pattern;
+    QString m_lowerPattern;
+    quint64 m_mask;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+// Qt
+#include <QObject> // Required for inheritance
+#include <QString>
+
+/**
+ * @brief Class, that describes source of hover
+ * information for QCodeEditor. Requests are answered
+ * asynchronously with `hoverReady` signal, so slow
+ * providers (external tools) don't block editor.
+ */
+class QHoverProvider : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param parent Pointer to parent QObject.
+     */
+    explicit QHoverProvider(QObject* parent=nullptr);
+
+    /**
+     * @brief Method for requesting hover information.
+     * Provider has to emit `hoverReady` with the same
+     * request id, immediately or later.
+     * @param requestId Request id.
+     * @param word Word under mouse.
+     * @param position Position of word in document.
+     */
+    virtual void requestHover(int requestId, const QString& word, int position) = 0;
+
+    /**
+     * @brief Method for cancelling request, that's not
+     * required anymore. Answer for it is ignored anyway.
+     * Default implementation does nothing.
+     * @param requestId Request id.
+     */
+    virtual void cancelHover(int requestId);
+
+Q_SIGNALS:
+
+    /**
+     * @brief Signal, that's emitted when hover information
+     * is ready.
+     * @param requestId Request id.
+     * @param text Hover text. Empty if there is no information.
+     */
+    void hoverReady(int requestId, QString text);
+};
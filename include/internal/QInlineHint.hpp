@@ -0,0 +1,25 @@
+#pragma once
+
+// Qt
+#include <QString>
+
+/**
+ * @brief Structure, that describes virtual text,
+ * that's shown before document position without
+ * document modification.
+ */
+struct QInlineHint
+{
+    QInlineHint() :
+        position(0),
+        text()
+    {}
+
+    QInlineHint(int p, QString t) :
+        position(p),
+        text(std::move(t))
+    {}
+
+    int position;
+    QString text;
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+// QCodeEditor
+#include <QInlineHint>
+
+// Qt
+#include <QtGlobal>
+#include <QVector>
+
+class QFontMetrics;
+
+/**
+ * @brief Class, that describes inline hints ordered
+ * by position with width, that's reserved for them
+ * in text layout. It's a balanced tree (treap) ordered
+ * by hint position. Every node keeps pending shift of
+ * it's children, so edits shift hints in logarithmic
+ * time.
+ */
+class QInlineHintIndex
+{
+public:
+
+    /**
+     * @brief Structure, that describes hint with
+     * reserved width in pixels.
+     */
+    struct Entry
+    {
+        QInlineHint hint;
+        int width;
+    };
+
+    /**
+     * @brief Constructor.
+     */
+    QInlineHintIndex();
+
+    /**
+     * @brief Destructor.
+     */
+    ~QInlineHintIndex();
+
+    // Disable copying
+    QInlineHintIndex(const QInlineHintIndex&) = delete;
+    QInlineHintIndex& operator=(const QInlineHintIndex&) = delete;
+
+    /**
+     * @brief Method for replacing all hints. Hints
+     * with the same position are joined.
+     * @param hints Hints in any order.
+     * @param metrics Metrics of hint font.
+     */
+    void setHints(QVector<QInlineHint> hints, const QFontMetrics& metrics);
+
+    /**
+     * @brief Method for removing all hints.
+     */
+    void clear();
+
+    /**
+     * @brief Method for getting number of hints.
+     */
+    int size() const;
+
+    /**
+     * @brief Method for shifting hints after document
+     * edit. Hints inside of removed text are removed,
+     * hint at edit position stays before inserted text.
+     * @param position Edit position.
+     * @param charsRemoved Number of removed characters.
+     * @param charsAdded Number of added characters.
+     */
+    void shift(int position, int charsRemoved, int charsAdded);
+
+    /**
+     * @brief Method for getting hints with position
+     * in range [start, end].
+     * @return Hints ordered by position.
+     */
+    QVector<Entry> hints(int start, int end) const;
+
+    /**
+     * @brief Method for getting all hints.
+     */
+    QVector<QInlineHint> hints() const;
+
+private:
+
+    struct Node;
+
+    /**
+     * @brief Method for shifting whole subtree.
+     */
+    static void apply(Node* node, int delta);
+
+    /**
+     * @brief Method for passing pending shift
+     * to children.
+     */
+    static void push(Node* node);
+
+    /**
+     * @brief Method for splitting tree into nodes
+     * before `position` and other nodes.
+     */
+    static void split(Node* node, int position, Node*& left, Node*& right);
+
+    /**
+     * @brief Method for merging trees. All nodes of
+     * `left` have to be before nodes of `right`.
+     */
+    static Node* merge(Node* left, Node* right);
+
+    /**
+     * @brief Method for collecting hints with position
+     * in range.
+     * @param offset Pending shift of ancestors.
+     */
+    static void collect(const Node* node,
+                        int offset,
+                        int start,
+                        int end,
+                        QVector<Entry>& result);
+
+    static int count(const Node* node);
+
+    static void destroy(Node* node);
+
+    /**
+     * @brief Method for generating node priority.
+     */
+    quint32 nextPriority();
+
+    Node* m_root;
+    int m_size;
+    quint32 m_seed;
+};
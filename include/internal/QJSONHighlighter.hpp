@@ -24,7 +24,7 @@ public:
 
 protected:
 
-    void highlightBlock(const QString& text) override;
+    void highlightSyntax(const QString& text) override;
 
 private:
     QVector<QHighlightRule> m_highlightRules;
@@ -4,6 +4,7 @@
 #include <QObject> // Required for inheritance
 #include <QString>
 #include <QMap>
+#include <QPair>
 
 class QIODevice;
 
@@ -48,10 +49,29 @@ public:
      */
     bool isLoaded() const;
 
+    /**
+     * @brief Method for getting token of line
+     * comment.
+     * @return Token. Empty if language has no
+     * line comments.
+     */
+    QString lineComment() const;
+
+    /**
+     * @brief Method for getting start and end
+     * tokens of block comment.
+     * @return Tokens. Empty if language has no
+     * block comments.
+     */
+    QPair<QString, QString> blockComment() const;
+
 private:
 
     bool m_loaded;
 
+    QString m_lineComment;
+    QPair<QString, QString> m_blockComment;
+
     QMap<
         QString,
         QStringList
@@ -28,7 +28,16 @@ public:
     explicit QLuaHighlighter(QTextDocument* document=nullptr);
 
 protected:
-    void highlightBlock(const QString& text) override;
+    void highlightSyntax(const QString& text) override;
+
+    /**
+     * @brief Method for getting indentation structure
+     * of block. Keywords, that open and close blocks
+     * (`function`, `then`, `do`, `repeat`, `end`,
+     * `until`), are counted with brackets.
+     */
+    BlockIndentation blockIndentation(const QString& text,
+                                      const QSyntaxBlockData* data) const override;
 
 private:
     QVector<QHighlightRule> m_highlightRules;
@@ -27,7 +27,15 @@ public:
     explicit QPythonHighlighter(QTextDocument* document=nullptr);
 
 protected:
-    void highlightBlock(const QString& text) override;
+    void highlightSyntax(const QString& text) override;
+
+    /**
+     * @brief Method for getting indentation structure
+     * of block. Block ending with colon is a header of
+     * lines with higher indentation.
+     */
+    BlockIndentation blockIndentation(const QString& text,
+                                      const QSyntaxBlockData* data) const override;
 
 private:
 
@@ -0,0 +1,73 @@
+#pragma once
+
+// Qt
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Class, that describes parsed snippet.
+ * Snippet text has tab stops `$1`, placeholders
+ * `${1:text}` and final cursor position `$0`.
+ * Tab stops with the same number are mirrored,
+ * empty mirrors get text of placeholder and
+ * placeholder, that contains mirror, is lengthened.
+ * Placeholders may contain tab stops, but not
+ * other placeholders.
+ * `\` escapes `$`, `}` and `\`.
+ */
+class QSnippet
+{
+public:
+
+    /**
+     * @brief Structure, that describes tab stop
+     * as range of snippet text.
+     */
+    struct TabStop
+    {
+        int number;
+        int start;
+        int length;
+    };
+
+    /**
+     * @brief Constructor.
+     * @param snippet Snippet source.
+     */
+    explicit QSnippet(const QString& snippet);
+
+    /**
+     * @brief Method for getting text, that's inserted
+     * into document.
+     */
+    const QString& text() const;
+
+    /**
+     * @brief Method for getting tab stops in order
+     * of position. There is always `$0` tab stop, it's
+     * added at text end if snippet has no one.
+     */
+    const QVector<TabStop>& tabStops() const;
+
+private:
+
+    /**
+     * @brief Method for inserting placeholder text
+     * into empty tab stops with the same number.
+     * @param parents Index of placeholder, that
+     * contains tab stop, or -1 for every tab stop.
+     */
+    void fillMirrors(const QVector<int>& parents);
+
+    /**
+     * @brief Method for reading tab stop number.
+     * @param snippet Snippet source.
+     * @param position Position of first digit. It's
+     * moved after number.
+     * @return Number or -1 if there are no digits.
+     */
+    static int readNumber(const QString& snippet, int& position);
+
+    QString m_text;
+    QVector<TabStop> m_tabStops;
+};
@@ -1,9 +1,22 @@
 #pragma once
 
+// QCodeEditor
+#include <QSyntaxBlockData>
+
 // Qt
 #include <QSyntaxHighlighter> // Required for inheritance
+#include <QSharedPointer>
+#include <QTextCharFormat>
+#include <QTextCursor>
+#include <QPointer>
+#include <QVector>
+#include <QPair>
 
 class QSyntaxStyle;
+class QBracketIndex;
+class QSyntaxParser;
+class QInlineHintIndex;
+class QTracer;
 
 /**
  * @brief Class, that descrubes highlighter with
@@ -13,6 +26,23 @@ class QStyleSyntaxHighlighter : public QSyntaxHighlighter
 {
 public:
 
+    /**
+     * @brief Structure, that describes how block
+     * changes indentation level.
+     */
+    struct BlockIndentation
+    {
+        // Change of block level (e.g. leading closing bracket)
+        int shift;
+
+        // Change of level of following blocks
+        int delta;
+
+        // Block opens block of lines with higher
+        // indentation (e.g. Python colon)
+        bool header;
+    };
+
     /**
      * @brief Constructor.
      * @param document Pointer to text document.
@@ -35,7 +65,303 @@ public:
      */
     QSyntaxStyle* syntaxStyle() const;
 
+    /**
+     * @brief Method for getting index of brackets
+     * outside of strings and comments.
+     * @return Pointer to bracket index.
+     */
+    QBracketIndex* bracketIndex() const;
+
+    /**
+     * @brief Method for getting index of elements
+     * (e.g. XML tags). Elements are indexed as
+     * brackets, see `QSyntaxBlockData::elementData`.
+     * @return Pointer to element index. nullptr if
+     * highlighter doesn't index elements.
+     */
+    QBracketIndex* elementIndex() const;
+
+    /**
+     * @brief Method for setting coloring of brackets
+     * by depth with "Parentheses1".."ParenthesesN"
+     * formats of syntax style.
+     */
+    void setRainbowParentheses(bool enabled);
+
+    /**
+     * @brief Method for getting is rainbow parentheses
+     * enabled.
+     * Default: false
+     */
+    bool rainbowParentheses() const;
+
+    /**
+     * @brief Method for setting incremental parsing
+     * backend. Parser is not owned by highlighter.
+     * Parser is attached to current document, so it
+     * receives edits before blocks are highlighted.
+     * After document is changed, parser has to be set
+     * again, until then `highlightSyntax` rules are used.
+     * @param parser Pointer to parser. If nullptr,
+     * `highlightSyntax` rules are used.
+     */
+    void setParser(QSyntaxParser* parser);
+
+    /**
+     * @brief Method for getting incremental parsing
+     * backend.
+     * @return Pointer to parser. May be nullptr.
+     */
+    QSyntaxParser* parser() const;
+
+    /**
+     * @brief Method for setting inline hints, that
+     * get horizontal space reserved by letter spacing
+     * of previous character. Hints at block start
+     * get no space. Hints are not owned by highlighter.
+     * @param hints Pointer to hints. May be nullptr.
+     */
+    void setInlineHints(const QInlineHintIndex* hints);
+
+    /**
+     * @brief Method for setting recorder of tracing
+     * spans. Highlighting of every block is recorded.
+     * Tracer is not owned by highlighter.
+     * @param tracer Pointer to tracer. May be nullptr.
+     */
+    void setTracer(QTracer* tracer);
+
+    /**
+     * @brief Method for setting comment tokens of
+     * language. They are used by comment toggling.
+     * @param lineComment Line comment token. May be
+     * empty.
+     * @param blockComment Block comment start and end
+     * tokens. May be empty.
+     */
+    void setCommentTokens(const QString& lineComment,
+                          const QPair<QString, QString>& blockComment);
+
+    /**
+     * @brief Method for getting line comment token.
+     * @return Token. Empty if it's not set.
+     */
+    QString lineComment() const;
+
+    /**
+     * @brief Method for getting block comment start
+     * and end tokens.
+     * @return Tokens. Empty if they're not set.
+     */
+    QPair<QString, QString> blockComment() const;
+
+    /**
+     * @brief Method for deferring highlighting. While
+     * deferred, changed blocks are only marked as pending,
+     * so big insertions return without highlighting.
+     * Pending range is kept by cursors, so it follows
+     * later edits. Pending blocks are left unhighlighted
+     * until `highlightPendingBlocks` reaches them.
+     */
+    void setHighlightingDeferred(bool deferred);
+
+    /**
+     * @brief Method for checking are there blocks,
+     * which highlighting was deferred.
+     */
+    bool hasPendingBlocks() const;
+
+    /**
+     * @brief Method for highlighting pending blocks
+     * in document order until time limit is reached.
+     * Every pending block is highlighted explicitly.
+     * @param msec Time limit in milliseconds.
+     * @return Are there pending blocks left.
+     */
+    bool highlightPendingBlocks(int msec);
+
+    /**
+     * @brief Method for highlighting all pending blocks
+     * without time limit. It's used by operations, that
+     * need structure of the whole document at once.
+     */
+    void highlightPendingBlocks();
+
+    /**
+     * @brief Method for getting indentation levels of
+     * document blocks for reindenting. Levels are taken
+     * from highlighted brackets outside of strings and
+     * comments and from `blockIndentation` in one pass.
+     * @param tabWidth Tab width in spaces, it's used for
+     * comparing original indentation of header blocks.
+     * @return Level of every block. -1 for blocks, which
+     * indentation has to be kept: blank blocks and blocks
+     * inside multiline strings and comments.
+     */
+    QVector<int> indentationLevels(int tabWidth) const;
+
+    /**
+     * @brief Method for checking does block close block
+     * of lines of previous header (e.g. leading closing
+     * bracket or Lua `end`). It's taken from shift of
+     * `blockIndentation`.
+     * @param block Document block.
+     */
+    bool isClosingBlock(const QTextBlock& block) const;
+
+protected:
+
+    /**
+     * @brief Method, that's called by QSyntaxHighlighter
+     * for every block. It calls `highlightSyntax` and
+     * updates block data from highlighted tokens.
+     */
+    void highlightBlock(const QString& text) override;
+
+    /**
+     * @brief Method for highlighting block text.
+     * Derived highlighters have to override this
+     * method instead of `highlightBlock`.
+     * @param text Block text.
+     */
+    virtual void highlightSyntax(const QString& text);
+
+    /**
+     * @brief Method for setting format from syntax
+     * style. "String" and "Comment" formats also mark
+     * characters as non code tokens.
+     * @param start Start position in block.
+     * @param count Number of characters.
+     * @param formatName Name of syntax style format.
+     */
+    void setStyleFormat(int start, int count, const QString& formatName);
+
+    /**
+     * @brief Method for enabling element index.
+     * It's called by derived highlighters, that
+     * override `blockElements`.
+     */
+    void setElementIndexEnabled(bool enabled);
+
+    /**
+     * @brief Method for getting elements of highlighted
+     * block for element index. Default implementation
+     * returns no elements.
+     * @param text Block text.
+     * @param data Block data with highlighted tokens.
+     * @return Elements as brackets in order of position.
+     */
+    virtual QVector<QSyntaxBlockData::Bracket> blockElements(const QString& text,
+                                                             const QSyntaxBlockData* data) const;
+
+    /**
+     * @brief Method for getting indentation structure
+     * of block. Default implementation uses brackets.
+     * @param text Block text.
+     * @param data Block data with highlighted tokens.
+     * May be nullptr, if block isn't highlighted.
+     */
+    virtual BlockIndentation blockIndentation(const QString& text,
+                                              const QSyntaxBlockData* data) const;
+
+    /**
+     * @brief Static method for getting indentation
+     * structure from brackets of block data. Leading
+     * closing brackets shift block to outer level.
+     */
+    static BlockIndentation bracketIndentation(const QString& text,
+                                               const QSyntaxBlockData* data);
+
+    /**
+     * @brief Methods, that hide QSyntaxHighlighter block
+     * state methods. Block state also keeps bracket depth
+     * at block end, so rainbow parentheses of following
+     * blocks are updated until depth converges. These
+     * methods work with highlighter state only.
+     */
+    int previousBlockState() const;
+    int currentBlockState() const;
+    void setCurrentBlockState(int newState);
+
 private:
+
+    /**
+     * @brief Method for updating current block data
+     * after highlighting.
+     * @return Current block data.
+     */
+    QSyntaxBlockData* updateBlockData(const QString& text);
+
+    /**
+     * @brief Method for updating nested element
+     * data of current block.
+     */
+    void updateElementData(QSyntaxBlockData* data, const QString& text);
+
+    /**
+     * @brief Method for coloring brackets of current
+     * block by depth.
+     * @param depth Depth at block start.
+     */
+    void highlightRainbow(const QSyntaxBlockData* data, int depth);
+
+    /**
+     * @brief Method for highlighting current block
+     * with parser spans.
+     */
+    void highlightParsed(const QString& text);
+
+    /**
+     * @brief Method for reserving space for inline
+     * hints of current block.
+     */
+    void reserveInlineHints(const QString& text);
+
+    /**
+     * @brief Method, that's called on document change
+     * before blocks are highlighted. It applies edit
+     * to parser.
+     */
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+
+    /**
+     * @brief Method, that's called on document change
+     * after edited blocks are highlighted. It rehighlights
+     * blocks, that were changed by parser outside of edit.
+     */
+    void onContentsChanged(int position, int charsRemoved, int charsAdded);
+
+    /**
+     * @brief Static methods for packing highlighter
+     * state and bracket depth into block state.
+     */
+    static int encodeState(int state, int depth);
+    static int decodeState(int blockState);
+
     QSyntaxStyle* m_syntaxStyle;
+
+    bool m_rainbowParentheses;
+    QVector<QTextCharFormat> m_rainbowFormats;
+
+    QSharedPointer<QBracketIndex> m_bracketIndex;
+    QSharedPointer<QBracketIndex> m_elementIndex;
+
+    QSyntaxParser* m_parser;
+    QPointer<QTextDocument> m_parserDocument;
+    QPair<int, int> m_parsedChange;
+    int m_parsedChangeDepth;
+
+    const QInlineHintIndex* m_inlineHints;
+
+    QTracer* m_tracer;
+
+    QString m_lineComment;
+    QPair<QString, QString> m_blockComment;
+
+    bool m_highlightingDeferred;
+    QTextCursor m_pendingStart;
+    QTextCursor m_pendingEnd;
+
+    QVector<QSyntaxBlockData::TokenType> m_tokens;
 };
 
@@ -0,0 +1,184 @@
+#pragma once
+
+// Qt
+#include <QTextBlockUserData> // Required for inheritance
+#include <QSharedPointer>
+#include <QScopedPointer>
+#include <QVector>
+#include <QChar>
+
+class QBracketIndex;
+
+/**
+ * @brief Class, that describes syntax information,
+ * that's stored by highlighter in every text block.
+ * Every block data is a node of bracket index.
+ */
+class QSyntaxBlockData : public QTextBlockUserData
+{
+public:
+
+    /**
+     * @brief Type of highlighted token.
+     */
+    enum class TokenType : quint8
+    {
+        Code,
+        String,
+        Comment
+    };
+
+    /**
+     * @brief Structure, that describes bracket
+     * outside of strings and comments.
+     */
+    struct Bracket
+    {
+        int position;
+        QChar character;
+    };
+
+    /**
+     * @brief Structure, that describes continuous
+     * string or comment token in block.
+     */
+    struct TokenSpan
+    {
+        int start;
+        int length;
+        TokenType type;
+    };
+
+    /**
+     * @brief Constructor.
+     * @param index Bracket index, that owns this block.
+     */
+    explicit QSyntaxBlockData(QSharedPointer<QBracketIndex> index);
+
+    /**
+     * @brief Destructor. Removes block from index.
+     */
+    ~QSyntaxBlockData() override;
+
+    // Disable copying
+    QSyntaxBlockData(const QSyntaxBlockData&) = delete;
+    QSyntaxBlockData& operator=(const QSyntaxBlockData&) = delete;
+
+    /**
+     * @brief Method for getting bracket index, this
+     * block belongs to.
+     */
+    QBracketIndex* index() const;
+
+    /**
+     * @brief Method for getting brackets of block
+     * in order of position.
+     */
+    const QVector<Bracket>& brackets() const;
+
+    /**
+     * @brief Method for setting brackets of block.
+     * Depth summary is recalculated. Index has to
+     * be updated after this call.
+     * @param brackets Brackets in order of position.
+     */
+    void setBrackets(QVector<Bracket> brackets);
+
+    /**
+     * @brief Method for getting string and comment
+     * tokens of block in order of position.
+     */
+    const QVector<TokenSpan>& tokenSpans() const;
+
+    /**
+     * @brief Method for setting string and comment
+     * tokens of block.
+     * @param spans Tokens in order of position.
+     */
+    void setTokenSpans(QVector<TokenSpan> spans);
+
+    /**
+     * @brief Method for getting type of token
+     * under position.
+     * @param positionInBlock Position in block.
+     */
+    TokenType tokenAt(int positionInBlock) const;
+
+    /**
+     * @brief Method for getting token span under
+     * position.
+     * @param positionInBlock Position in block.
+     * @return Pointer to span or nullptr if position
+     * is code.
+     */
+    const TokenSpan* tokenSpanAt(int positionInBlock) const;
+
+    /**
+     * @brief Method for getting depth change
+     * between block start and block end.
+     */
+    int depthDelta() const;
+
+    /**
+     * @brief Method for getting minimal depth inside
+     * block, relative to block start. It's never
+     * greater than 0.
+     */
+    int minimumDepth() const;
+
+    /**
+     * @brief Method for getting nested block data of
+     * element index. Elements (e.g. XML tags) are indexed
+     * as brackets: opening tag is `(` and closing
+     * tag is `)`.
+     * @return Pointer to element data. May be nullptr.
+     */
+    QSyntaxBlockData* elementData() const;
+
+    /**
+     * @brief Method for setting nested block data of
+     * element index. Block data takes ownership.
+     * @param data Pointer to element data.
+     */
+    void setElementData(QSyntaxBlockData* data);
+
+    /**
+     * @brief Static method for checking is character
+     * a bracket, that's tracked by index.
+     */
+    static bool isBracket(QChar c);
+
+    /**
+     * @brief Static method for checking is character
+     * an opening bracket.
+     */
+    static bool isOpeningBracket(QChar c);
+
+    /**
+     * @brief Static method for getting bracket, that
+     * pairs with provided one.
+     * @return Pair bracket or null char.
+     */
+    static QChar pairBracket(QChar c);
+
+private:
+    friend class QBracketIndex;
+
+    QSharedPointer<QBracketIndex> m_index;
+
+    QVector<Bracket> m_brackets;
+    QVector<TokenSpan> m_tokenSpans;
+    int m_depthDelta;
+    int m_minimumDepth;
+
+    QScopedPointer<QSyntaxBlockData> m_elementData;
+
+    // Index tree node
+    QSyntaxBlockData* m_parent;
+    QSyntaxBlockData* m_left;
+    QSyntaxBlockData* m_right;
+    quint32 m_priority;
+    int m_size;
+    int m_totalDelta;
+    int m_totalMinimum;
+};
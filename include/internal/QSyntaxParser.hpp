@@ -0,0 +1,81 @@
+#pragma once
+
+// Qt
+#include <QString>
+#include <QVector>
+#include <QPair>
+
+class QTextDocument;
+
+/**
+ * @brief Class, that describes interface of incremental
+ * parsing backend for QStyleSyntaxHighlighter. Parser
+ * keeps persistent syntax tree of document, applies
+ * edits to it and reparses changed subtrees only.
+ * Highlighter takes formats from parser instead of
+ * `highlightSyntax` rules, when parser is set.
+ */
+class QSyntaxParser
+{
+public:
+
+    /**
+     * @brief Structure, that describes highlighted range
+     * of document with name of syntax style format.
+     */
+    struct Span
+    {
+        int start;
+        int length;
+        QString formatName;
+    };
+
+    virtual ~QSyntaxParser() = default;
+
+    /**
+     * @brief Method for parsing whole document.
+     * It's called when parser is attached to document.
+     * @param document Pointer to document. May be nullptr.
+     */
+    virtual void reset(const QTextDocument* document) = 0;
+
+    /**
+     * @brief Method for applying document edit to tree
+     * and reparsing changed subtrees. It's called before
+     * edited blocks are highlighted.
+     * @param document Pointer to edited document.
+     * @param position Edit position.
+     * @param charsRemoved Number of removed characters.
+     * @param charsAdded Number of added characters.
+     * @return Range [start, end) of edited document, which
+     * highlighting was changed. It may be wider than edit,
+     * for example after raw string opening. {-1, -1} if
+     * only edited range was changed.
+     */
+    virtual QPair<int, int> edit(const QTextDocument* document,
+                                 int position,
+                                 int charsRemoved,
+                                 int charsAdded) = 0;
+
+    /**
+     * @brief Method for getting highlighted spans, that
+     * intersect document range.
+     * @param start Range start.
+     * @param end Range end.
+     */
+    virtual QVector<Span> spans(int start, int end) const = 0;
+
+    /**
+     * @brief Method for getting the smallest tree node,
+     * that contains range and is bigger than range.
+     * Default implementation has no structure.
+     * @return Node range [start, end) or {-1, -1}.
+     */
+    virtual QPair<int, int> parentNode(int start, int end) const
+    {
+        Q_UNUSED(start)
+        Q_UNUSED(end)
+
+        return {-1, -1};
+    }
+};
@@ -50,6 +50,14 @@ public:
      */
     QTextCharFormat getFormat(QString name) const;
 
+    /**
+     * @brief Method for checking is format with
+     * property name defined by style.
+     * @param name Property name.
+     * @return Is defined.
+     */
+    bool hasFormat(QString name) const;
+
     /**
      * @brief Static method for getting default style.
      * @return Pointer to default style.
@@ -0,0 +1,206 @@
+#pragma once
+
+// Qt
+#include <QTextBlock>
+#include <QString>
+#include <QPair>
+
+class QTextDocument;
+class QBracketIndex;
+class QSyntaxBlockData;
+class QSyntaxParser;
+class QStyleSyntaxHighlighter;
+
+/**
+ * @brief Class, that describes lightweight syntax
+ * tree of document. Nodes are not stored, they are
+ * computed on request from highlighter block data
+ * and bracket index. So tree is updated incrementally
+ * with highlighting of edited blocks only. Nodes
+ * of incremental parser are used too, if it's set.
+ */
+class QSyntaxTree
+{
+public:
+
+    /**
+     * @brief Type of syntax node. Types are ordered
+     * from the innermost, except parser nodes.
+     */
+    enum class NodeType
+    {
+        Invalid,
+        Word,
+        Token,
+        Segment,
+        Contents,
+        Brackets,
+        Element,
+        Lines,
+        IndentationBlock,
+        Document,
+        Parsed
+    };
+
+    /**
+     * @brief Structure, that describes syntax node
+     * as document range [start, end).
+     */
+    struct Node
+    {
+        NodeType type;
+        int start;
+        int end;
+
+        bool isValid() const
+        {
+            return type != NodeType::Invalid;
+        }
+    };
+
+    /**
+     * @brief Constructor.
+     * @param document Pointer to document.
+     * @param index Pointer to bracket index of document
+     * highlighter. May be nullptr, then only words, lines
+     * and indentation are used.
+     * @param parser Pointer to incremental parser of
+     * document highlighter. May be nullptr.
+     * @param elementIndex Pointer to element index of
+     * document highlighter. May be nullptr.
+     * @param highlighter Pointer to document highlighter.
+     * It tells which lines close indentation blocks. May
+     * be nullptr, then only closing brackets do.
+     */
+    QSyntaxTree(const QTextDocument* document,
+                const QBracketIndex* index,
+                const QSyntaxParser* parser=nullptr,
+                const QBracketIndex* elementIndex=nullptr,
+                const QStyleSyntaxHighlighter* highlighter=nullptr);
+
+    // Disable copying
+    QSyntaxTree(const QSyntaxTree&) = delete;
+    QSyntaxTree& operator=(const QSyntaxTree&) = delete;
+
+    /**
+     * @brief Method for getting the innermost node
+     * at position.
+     * @param position Position in document.
+     */
+    Node nodeAt(int position) const;
+
+    /**
+     * @brief Method for getting the smallest node,
+     * that contains range and is bigger than range.
+     * @param start Range start.
+     * @param end Range end.
+     */
+    Node parentNode(int start, int end) const;
+
+private:
+
+    /**
+     * @brief Method for getting the smallest node
+     * from block data and bracket index.
+     */
+    Node textNode(int start, int end) const;
+
+    /**
+     * @brief Method for getting block data, that belongs
+     * to bracket index.
+     */
+    const QSyntaxBlockData* blockData(const QTextBlock& block) const;
+
+    /**
+     * @brief Method for getting brackets, that enclose
+     * position.
+     */
+    QPair<int, int> enclosingBrackets(int position) const;
+
+    /**
+     * @brief Method for getting tags of element, that
+     * encloses position.
+     * @return Positions of opening tag start and closing
+     * tag start.
+     */
+    QPair<int, int> enclosingElement(int position) const;
+
+    /**
+     * @brief Method for searching end of tag.
+     * @param position Position of tag start.
+     * @return Position of `>` or -1.
+     */
+    int findTagEnd(int position) const;
+
+    Node wordNode(int start, int end) const;
+
+    Node tokenNode(int start, int end) const;
+
+    /**
+     * @brief Method for getting part of bracket contents
+     * between `,` or `;` separators on the same depth.
+     * @param first First position of contents.
+     * @param last Position after contents.
+     */
+    Node segmentNode(int first, int last, int start, int end) const;
+
+    Node linesNode(int start, int end) const;
+
+    /**
+     * @brief Method for getting line with lower indentation
+     * with all following lines with higher indentation.
+     * Lines between indexed brackets are skipped, they're
+     * nested deeper than the bracket lines.
+     */
+    Node indentationNode(int start, int end) const;
+
+    /**
+     * @brief Method for searching block with the other
+     * bracket of pair, which spans blocks.
+     * @param block Indexed block.
+     * @param backward First closing bracket of block is
+     * matched if true, last opening bracket otherwise.
+     * @return Block of matching bracket or invalid block.
+     */
+    QTextBlock findPairedBlock(const QTextBlock& block, bool backward) const;
+
+    /**
+     * @brief Method for checking does block close block
+     * of lines of previous header.
+     * @param block Document block.
+     * @param level Block indentation.
+     */
+    bool isClosingBlock(const QTextBlock& block, int level) const;
+
+    /**
+     * @brief Method for searching separator on the same
+     * depth. Nested brackets, strings and comments are
+     * skipped.
+     * @param position Position to start from.
+     * @param limit Position to stop at.
+     * @param direction 1 or -1.
+     * @return Position of separator or `limit`.
+     */
+    int findSeparator(int position, int limit, int direction) const;
+
+    /**
+     * @brief Method for creating node with trimmed
+     * whitespaces.
+     */
+    Node trimmed(NodeType type, int start, int end) const;
+
+    /**
+     * @brief Method for getting indentation of block.
+     * Characters are read from document, so block
+     * text isn't copied.
+     * @return Number of whitespace characters or -1
+     * for blank block.
+     */
+    int indentation(const QTextBlock& block) const;
+
+    const QTextDocument* m_document;
+    const QBracketIndex* m_index;
+    const QSyntaxParser* m_parser;
+    const QBracketIndex* m_elementIndex;
+    const QStyleSyntaxHighlighter* m_highlighter;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+// Qt
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Class, that describes recorder of tracing
+ * spans. Spans are exported in Chrome trace event
+ * JSON format, that's loaded by trace viewers
+ * (chrome://tracing, Perfetto).
+ */
+class QTracer
+{
+public:
+
+    /**
+     * @brief Track of span in trace viewer.
+     */
+    enum class Track
+    {
+        Editor = 1,
+        Latency = 2
+    };
+
+    /**
+     * @brief Class, that records span from construction
+     * to destruction. Nothing is recorded if tracer
+     * is nullptr.
+     */
+    class Span
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param tracer Pointer to tracer. May be nullptr.
+         * @param name Span name. It has to be string literal.
+         */
+        Span(QTracer* tracer, const char* name);
+
+        ~Span();
+
+        // Disable copying
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        QTracer* m_tracer;
+        const char* m_name;
+        qint64 m_start;
+    };
+
+    /**
+     * @brief Constructor.
+     */
+    QTracer();
+
+    // Disable copying
+    QTracer(const QTracer&) = delete;
+    QTracer& operator=(const QTracer&) = delete;
+
+    /**
+     * @brief Method for getting time since tracer
+     * creation.
+     * @return Time in nanoseconds.
+     */
+    qint64 now() const;
+
+    /**
+     * @brief Method for recording span.
+     * @param name Span name. It has to be string literal.
+     * @param start Start time in nanoseconds.
+     * @param end End time in nanoseconds.
+     * @param track Track of span.
+     */
+    void addSpan(const char* name, qint64 start, qint64 end, Track track=Track::Editor);
+
+    /**
+     * @brief Method for removing recorded spans.
+     */
+    void clear();
+
+    /**
+     * @brief Method for getting number of recorded
+     * spans.
+     */
+    int size() const;
+
+    /**
+     * @brief Method for exporting spans in Chrome
+     * trace event JSON format.
+     */
+    QByteArray toJson() const;
+
+    /**
+     * @brief Method for saving trace to file.
+     * @param fileName Path to file.
+     * @return Success.
+     */
+    bool save(const QString& fileName) const;
+
+private:
+
+    struct Event
+    {
+        const char* name;
+        qint64 start;
+        qint64 end;
+        Track track;
+    };
+
+    QElapsedTimer m_timer;
+    QVector<Event> m_events;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+// Qt
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QTextDocument;
+
+/**
+ * @brief Class, that describes index of document
+ * words with their frequencies. Words are kept for
+ * every block, so index is updated by changed blocks
+ * only. Frequencies are sorted by word, so words with
+ * prefix are found as one range.
+ */
+class QWordIndex
+{
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    QWordIndex();
+
+    // Disable copying
+    QWordIndex(const QWordIndex&) = delete;
+    QWordIndex& operator=(const QWordIndex&) = delete;
+
+    /**
+     * @brief Method for removing all words.
+     */
+    void clear();
+
+    /**
+     * @brief Method for indexing all document blocks.
+     * @param document Pointer to document.
+     */
+    void rebuild(const QTextDocument* document);
+
+    /**
+     * @brief Method for updating index after document
+     * edit. Only blocks covered by edit are read again.
+     * @param document Pointer to edited document.
+     * @param position Edit position.
+     * @param charsRemoved Number of removed characters.
+     * @param charsAdded Number of added characters.
+     */
+    void update(const QTextDocument* document,
+                int position,
+                int charsRemoved,
+                int charsAdded);
+
+    /**
+     * @brief Method for getting number of word
+     * occurrences in document.
+     */
+    int frequency(const QString& word) const;
+
+    /**
+     * @brief Method for getting words, that start
+     * with prefix. Words are ranked by frequency and
+     * by distance to block, words near block go first.
+     * @param prefix Word prefix. The prefix itself isn't
+     * a completion.
+     * @param blockNumber Number of block with cursor.
+     * @param limit Maximum number of words.
+     * @return Words in rank order.
+     */
+    QStringList completions(const QString& prefix, int blockNumber, int limit) const;
+
+private:
+
+    /**
+     * @brief Static method for getting identifiers
+     * of block text.
+     */
+    static QVector<QString> blockWords(const QString& text);
+
+    void addWords(const QVector<QString>& words);
+
+    void removeWords(const QVector<QString>& words);
+
+    QVector<QVector<QString>> m_blockWords;
+    QMap<QString, int> m_frequencies;
+};
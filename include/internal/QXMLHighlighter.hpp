@@ -24,11 +24,27 @@ public:
 
 protected:
 
-    void highlightBlock(const QString& text) override;
+    void highlightSyntax(const QString& text) override;
+
+    /**
+     * @brief Method for getting tags of block for
+     * element index. Opening tag is indexed at `<`,
+     * closing tag at `</` and self closing tag end
+     * at `/>`.
+     */
+    QVector<QSyntaxBlockData::Bracket> blockElements(const QString& text,
+                                                     const QSyntaxBlockData* data) const override;
+
+    /**
+     * @brief Method for getting indentation structure
+     * of block from elements instead of brackets.
+     */
+    BlockIndentation blockIndentation(const QString& text,
+                                      const QSyntaxBlockData* data) const override;
 
 private:
 
-    void highlightByRegex(const QTextCharFormat& format,
+    void highlightByRegex(const QString& formatName,
                           const QRegularExpression& regex,
                           const QString& text);
 
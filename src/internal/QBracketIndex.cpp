@@ -0,0 +1,658 @@
+// QCodeEditor
+#include <QBracketIndex>
+#include <QSyntaxBlockData>
+
+// Qt
+#include <QTextBlock>
+#include <QTextDocument>
+
+// C++ STL
+#include <algorithm>
+#include <cstdlib>
+
+QBracketIndex::QBracketIndex() :
+    m_root(nullptr),
+    m_seed(2463534242u)
+{
+
+}
+
+int QBracketIndex::blockCount() const
+{
+    return m_root ? m_root->m_size : 0;
+}
+
+bool QBracketIndex::isComplete(const QTextDocument* document) const
+{
+    return document != nullptr &&
+           blockCount() == document->blockCount();
+}
+
+int QBracketIndex::depthAt(const QTextBlock& block) const
+{
+    auto data = blockData(block);
+
+    if (data == nullptr)
+    {
+        return 0;
+    }
+
+    return depthBefore(data);
+}
+
+int QBracketIndex::findMatchingBracket(const QTextBlock& block,
+                                       int positionInBlock,
+                                       int blockLimit) const
+{
+    auto data = blockData(block);
+
+    if (data == nullptr)
+    {
+        return -1;
+    }
+
+    auto index = bracketIndex(data, positionInBlock);
+
+    if (index >= data->m_brackets.size() ||
+        data->m_brackets[index].position != positionInBlock)
+    {
+        return -1;
+    }
+
+    auto depth = depthBefore(data) + relativeDepth(data, index);
+
+    if (QSyntaxBlockData::isOpeningBracket(data->m_brackets[index].character))
+    {
+        return searchForward(block, data, index + 1, depth, blockLimit);
+    }
+
+    return searchBackward(block, data, index, depth - 1, blockLimit);
+}
+
+QPair<int, int> QBracketIndex::findEnclosingBrackets(const QTextBlock& block,
+                                                     int positionInBlock) const
+{
+    auto data = blockData(block);
+
+    if (data == nullptr)
+    {
+        return {-1, -1};
+    }
+
+    auto index = bracketIndex(data, positionInBlock);
+
+    // Depth is negative after unmatched closing brackets,
+    // so enclosing brackets are searched relative to it
+    auto depth = depthBefore(data) + relativeDepth(data, index);
+
+    return {
+        searchBackward(block, data, index, depth - 1, 0),
+        searchForward(block, data, index, depth - 1, 0)
+    };
+}
+
+int QBracketIndex::bracketIndex(const QSyntaxBlockData* data, int positionInBlock) const
+{
+    auto& brackets = data->m_brackets;
+
+    auto bracket = std::lower_bound(
+        brackets.begin(),
+        brackets.end(),
+        positionInBlock,
+        [](const QSyntaxBlockData::Bracket& b, int position)
+        { return b.position < position; }
+    );
+
+    return static_cast<int>(bracket - brackets.begin());
+}
+
+int QBracketIndex::relativeDepth(const QSyntaxBlockData* data, int index) const
+{
+    int depth = 0;
+
+    for (auto i = 0; i < index; ++i)
+    {
+        depth += depthStep(data->m_brackets[i].character);
+    }
+
+    return depth;
+}
+
+int QBracketIndex::depthStep(QChar bracket)
+{
+    return QSyntaxBlockData::isOpeningBracket(bracket) ? 1 : -1;
+}
+
+int QBracketIndex::searchForward(const QTextBlock& block,
+                                 const QSyntaxBlockData* data,
+                                 int first,
+                                 int target,
+                                 int blockLimit) const
+{
+    auto& brackets = data->m_brackets;
+    auto depth = depthBefore(data) + relativeDepth(data, first);
+
+    // Searching in the same block
+    for (auto i = first; i < brackets.size(); ++i)
+    {
+        depth += depthStep(brackets[i].character);
+
+        if (depth == target)
+        {
+            return block.position() + brackets[i].position;
+        }
+    }
+
+    int foundDepth = 0;
+    auto found = findNext(data, depth, target, &foundDepth);
+
+    if (found == nullptr)
+    {
+        return -1;
+    }
+
+    for (auto& bracket : found->m_brackets)
+    {
+        foundDepth += depthStep(bracket.character);
+
+        if (foundDepth == target)
+        {
+            return blockPosition(block, found, blockLimit, bracket.position);
+        }
+    }
+
+    return -1;
+}
+
+int QBracketIndex::searchBackward(const QTextBlock& block,
+                                  const QSyntaxBlockData* data,
+                                  int last,
+                                  int target,
+                                  int blockLimit) const
+{
+    auto& brackets = data->m_brackets;
+    auto start = depthBefore(data);
+    auto depth = start + relativeDepth(data, last);
+
+    // Searching in the same block
+    for (auto i = last - 1; i >= 0; --i)
+    {
+        depth -= depthStep(brackets[i].character);
+
+        if (depth == target)
+        {
+            return block.position() + brackets[i].position;
+        }
+    }
+
+    int foundDepth = 0;
+    auto found = findPrevious(data, start, target, &foundDepth);
+
+    if (found == nullptr)
+    {
+        return -1;
+    }
+
+    depth = foundDepth + found->m_depthDelta;
+
+    for (int i = found->m_brackets.size() - 1; i >= 0; --i)
+    {
+        depth -= depthStep(found->m_brackets[i].character);
+
+        if (depth == target)
+        {
+            return blockPosition(block, found, blockLimit, found->m_brackets[i].position);
+        }
+    }
+
+    return -1;
+}
+
+int QBracketIndex::blockPosition(const QTextBlock& origin,
+                                 const QSyntaxBlockData* data,
+                                 int blockLimit,
+                                 int positionInBlock) const
+{
+    auto number = blockNumber(data);
+
+    if (blockLimit > 0 &&
+        std::abs(number - origin.blockNumber()) > blockLimit)
+    {
+        return -1;
+    }
+
+    auto block = origin.document()->findBlockByNumber(number);
+
+    if (!block.isValid())
+    {
+        return -1;
+    }
+
+    return block.position() + positionInBlock;
+}
+
+const QSyntaxBlockData* QBracketIndex::blockData(const QTextBlock& block) const
+{
+    if (!block.isValid())
+    {
+        return nullptr;
+    }
+
+    auto data = dynamic_cast<QSyntaxBlockData*>(block.userData());
+
+    // Element index nodes are nested into block data
+    if (data != nullptr &&
+        data->index() != this)
+    {
+        data = data->elementData();
+    }
+
+    if (data == nullptr ||
+        data->index() != this)
+    {
+        return nullptr;
+    }
+
+    return data;
+}
+
+void QBracketIndex::insert(QSyntaxBlockData* data, QSyntaxBlockData* previous)
+{
+    data->m_priority = nextPriority();
+    data->m_parent = nullptr;
+    data->m_left = nullptr;
+    data->m_right = nullptr;
+    pull(data);
+
+    if (m_root == nullptr)
+    {
+        m_root = data;
+        return;
+    }
+
+    QSyntaxBlockData* parent = nullptr;
+
+    if (previous == nullptr || previous->m_right != nullptr)
+    {
+        // Leftmost node of subtree, that's going after `previous`
+        parent = previous == nullptr ? m_root : previous->m_right;
+
+        while (parent->m_left)
+        {
+            parent = parent->m_left;
+        }
+
+        parent->m_left = data;
+    }
+    else
+    {
+        parent = previous;
+        parent->m_right = data;
+    }
+
+    data->m_parent = parent;
+    pullUp(parent);
+
+    while (data->m_parent &&
+           data->m_priority > data->m_parent->m_priority)
+    {
+        rotateUp(data);
+    }
+}
+
+void QBracketIndex::remove(QSyntaxBlockData* data)
+{
+    // Moving node down to leaf
+    while (data->m_left || data->m_right)
+    {
+        QSyntaxBlockData* child = nullptr;
+
+        if (data->m_left == nullptr)
+        {
+            child = data->m_right;
+        }
+        else if (data->m_right == nullptr)
+        {
+            child = data->m_left;
+        }
+        else
+        {
+            child = data->m_left->m_priority > data->m_right->m_priority ?
+                data->m_left : data->m_right;
+        }
+
+        rotateUp(child);
+    }
+
+    auto parent = data->m_parent;
+
+    if (parent == nullptr)
+    {
+        if (m_root == data)
+        {
+            m_root = nullptr;
+        }
+    }
+    else
+    {
+        if (parent->m_left == data)
+        {
+            parent->m_left = nullptr;
+        }
+        else
+        {
+            parent->m_right = nullptr;
+        }
+
+        pullUp(parent);
+    }
+
+    data->m_parent = nullptr;
+}
+
+void QBracketIndex::update(QSyntaxBlockData* data)
+{
+    pullUp(data);
+}
+
+int QBracketIndex::depthBefore(const QSyntaxBlockData* data) const
+{
+    int depth = data->m_left ? data->m_left->m_totalDelta : 0;
+
+    for (auto node = data; node->m_parent; node = node->m_parent)
+    {
+        auto parent = node->m_parent;
+
+        if (parent->m_right == node)
+        {
+            depth += parent->m_depthDelta;
+
+            if (parent->m_left)
+            {
+                depth += parent->m_left->m_totalDelta;
+            }
+        }
+    }
+
+    return depth;
+}
+
+int QBracketIndex::blockNumber(const QSyntaxBlockData* data) const
+{
+    int number = data->m_left ? data->m_left->m_size : 0;
+
+    for (auto node = data; node->m_parent; node = node->m_parent)
+    {
+        auto parent = node->m_parent;
+
+        if (parent->m_right == node)
+        {
+            number += 1 + (parent->m_left ? parent->m_left->m_size : 0);
+        }
+    }
+
+    return number;
+}
+
+const QSyntaxBlockData* QBracketIndex::findNext(const QSyntaxBlockData* data,
+                                                int depth,
+                                                int target,
+                                                int* startDepth) const
+{
+    auto node = data;
+
+    if (node->m_right)
+    {
+        if (depth + node->m_right->m_totalMinimum <= target)
+        {
+            return descendFirst(node->m_right, depth, target, startDepth);
+        }
+
+        depth += node->m_right->m_totalDelta;
+    }
+
+    while (node->m_parent)
+    {
+        auto parent = node->m_parent;
+
+        if (parent->m_left == node)
+        {
+            if (depth + parent->m_minimumDepth <= target)
+            {
+                *startDepth = depth;
+                return parent;
+            }
+
+            depth += parent->m_depthDelta;
+
+            if (parent->m_right)
+            {
+                if (depth + parent->m_right->m_totalMinimum <= target)
+                {
+                    return descendFirst(parent->m_right, depth, target, startDepth);
+                }
+
+                depth += parent->m_right->m_totalDelta;
+            }
+        }
+
+        node = parent;
+    }
+
+    return nullptr;
+}
+
+const QSyntaxBlockData* QBracketIndex::findPrevious(const QSyntaxBlockData* data,
+                                                    int depth,
+                                                    int target,
+                                                    int* startDepth) const
+{
+    auto node = data;
+
+    if (node->m_left)
+    {
+        auto start = depth - node->m_left->m_totalDelta;
+
+        if (start + node->m_left->m_totalMinimum <= target)
+        {
+            return descendLast(node->m_left, depth, target, startDepth);
+        }
+
+        depth = start;
+    }
+
+    while (node->m_parent)
+    {
+        auto parent = node->m_parent;
+
+        if (parent->m_right == node)
+        {
+            auto start = depth - parent->m_depthDelta;
+
+            if (start + parent->m_minimumDepth <= target)
+            {
+                *startDepth = start;
+                return parent;
+            }
+
+            depth = start;
+
+            if (parent->m_left)
+            {
+                start = depth - parent->m_left->m_totalDelta;
+
+                if (start + parent->m_left->m_totalMinimum <= target)
+                {
+                    return descendLast(parent->m_left, depth, target, startDepth);
+                }
+
+                depth = start;
+            }
+        }
+
+        node = parent;
+    }
+
+    return nullptr;
+}
+
+const QSyntaxBlockData* QBracketIndex::descendFirst(const QSyntaxBlockData* node,
+                                                    int depth,
+                                                    int target,
+                                                    int* startDepth) const
+{
+    while (node)
+    {
+        if (node->m_left)
+        {
+            if (depth + node->m_left->m_totalMinimum <= target)
+            {
+                node = node->m_left;
+                continue;
+            }
+
+            depth += node->m_left->m_totalDelta;
+        }
+
+        if (depth + node->m_minimumDepth <= target)
+        {
+            *startDepth = depth;
+            return node;
+        }
+
+        depth += node->m_depthDelta;
+        node = node->m_right;
+    }
+
+    return nullptr;
+}
+
+const QSyntaxBlockData* QBracketIndex::descendLast(const QSyntaxBlockData* node,
+                                                   int depth,
+                                                   int target,
+                                                   int* startDepth) const
+{
+    while (node)
+    {
+        if (node->m_right)
+        {
+            auto start = depth - node->m_right->m_totalDelta;
+
+            if (start + node->m_right->m_totalMinimum <= target)
+            {
+                node = node->m_right;
+                continue;
+            }
+
+            depth = start;
+        }
+
+        auto start = depth - node->m_depthDelta;
+
+        if (start + node->m_minimumDepth <= target)
+        {
+            *startDepth = start;
+            return node;
+        }
+
+        depth = start;
+        node = node->m_left;
+    }
+
+    return nullptr;
+}
+
+void QBracketIndex::pull(QSyntaxBlockData* node)
+{
+    int size = 1;
+    int delta = 0;
+    int minimum = 0;
+
+    if (node->m_left)
+    {
+        size += node->m_left->m_size;
+        delta = node->m_left->m_totalDelta;
+        minimum = node->m_left->m_totalMinimum;
+    }
+
+    minimum = std::min(minimum, delta + node->m_minimumDepth);
+    delta += node->m_depthDelta;
+
+    if (node->m_right)
+    {
+        size += node->m_right->m_size;
+        minimum = std::min(minimum, delta + node->m_right->m_totalMinimum);
+        delta += node->m_right->m_totalDelta;
+    }
+
+    node->m_size = size;
+    node->m_totalDelta = delta;
+    node->m_totalMinimum = minimum;
+}
+
+void QBracketIndex::pullUp(QSyntaxBlockData* node)
+{
+    while (node)
+    {
+        pull(node);
+        node = node->m_parent;
+    }
+}
+
+void QBracketIndex::rotateUp(QSyntaxBlockData* node)
+{
+    auto parent = node->m_parent;
+    auto grandParent = parent->m_parent;
+
+    if (parent->m_left == node)
+    {
+        parent->m_left = node->m_right;
+
+        if (node->m_right)
+        {
+            node->m_right->m_parent = parent;
+        }
+
+        node->m_right = parent;
+    }
+    else
+    {
+        parent->m_right = node->m_left;
+
+        if (node->m_left)
+        {
+            node->m_left->m_parent = parent;
+        }
+
+        node->m_left = parent;
+    }
+
+    parent->m_parent = node;
+    node->m_parent = grandParent;
+
+    if (grandParent == nullptr)
+    {
+        m_root = node;
+    }
+    else if (grandParent->m_left == parent)
+    {
+        grandParent->m_left = node;
+    }
+    else
+    {
+        grandParent->m_right = node;
+    }
+
+    pull(parent);
+    pull(node);
+}
+
+quint32 QBracketIndex::nextPriority()
+{
+    // xorshift32
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    return m_seed;
+}
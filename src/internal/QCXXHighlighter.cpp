@@ -31,6 +31,8 @@ QCXXHighlighter::QCXXHighlighter(QTextDocument* document) :
         return;
     }
 
+    setCommentTokens(language.lineComment(), language.blockComment());
+
     auto keys = language.keys();
     for (auto&& key : keys)
     {
@@ -56,6 +58,12 @@ QCXXHighlighter::QCXXHighlighter(QTextDocument* document) :
         "String"
     });
 
+    // Characters
+    m_highlightRules.append({
+        QRegularExpression(R"('(?:\\.|[^'\\\n])')"),
+        "String"
+    });
+
     // Define
     m_highlightRules.append({
         QRegularExpression(R"(#[a-zA-Z_]+)"),
@@ -69,7 +77,7 @@ QCXXHighlighter::QCXXHighlighter(QTextDocument* document) :
     });
 }
 
-void QCXXHighlighter::highlightBlock(const QString& text)
+void QCXXHighlighter::highlightSyntax(const QString& text)
 {
     // Checking for include
     {
@@ -79,16 +87,16 @@ void QCXXHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Preprocessor")
+                "Preprocessor"
             );
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(1),
                 match.capturedLength(1),
-                syntaxStyle()->getFormat("String")
+                "String"
             );
         }
     }
@@ -100,16 +108,16 @@ void QCXXHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Type")
+                "Type"
             );
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(2),
                 match.capturedLength(2),
-                syntaxStyle()->getFormat("Function")
+                "Function"
             );
         }
     }
@@ -120,10 +128,10 @@ void QCXXHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(1),
                 match.capturedLength(1),
-                syntaxStyle()->getFormat("Type")
+                "Type"
             );
         }
     }
@@ -136,10 +144,10 @@ void QCXXHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat(rule.formatName)
+                rule.formatName
             );
         }
     }
@@ -169,10 +177,10 @@ void QCXXHighlighter::highlightBlock(const QString& text)
             commentLength = endIndex - startIndex + match.capturedLength();
         }
 
-        setFormat(
+        setStyleFormat(
             startIndex,
             commentLength,
-            syntaxStyle()->getFormat("Comment")
+            "Comment"
         );
         startIndex = text.indexOf(m_commentStartPattern, startIndex + commentLength);
     }
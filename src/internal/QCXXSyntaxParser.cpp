@@ -0,0 +1,759 @@
+// QCodeEditor
+#include <QCXXSyntaxParser>
+#include <QLanguage>
+#include <QSyntaxBlockData>
+
+// Qt
+#include <QFile>
+#include <QTextDocument>
+#include <QTextBlock>
+
+// C++ STL
+#include <algorithm>
+
+namespace
+{
+    // Formats, that are always known by parser
+    enum Format
+    {
+        Bracket = -1,
+        Comment = 0,
+        String = 1,
+        Number = 2,
+        Preprocessor = 3
+    };
+
+    bool isWordCharacter(QChar c)
+    {
+        return c.isLetterOrNumber() || c == '_';
+    }
+
+    // Returns closing sequence of raw string, that starts
+    // with word [start, end), or empty string
+    QString rawStringClosing(const QString& text, int start, int end)
+    {
+        static const QStringList prefixes = {"R", "LR", "uR", "UR", "u8R"};
+
+        if (end >= text.size() ||
+            text[end] != '"' ||
+            !prefixes.contains(text.mid(start, end - start)))
+        {
+            return QString();
+        }
+
+        // Delimiter is up to 16 characters without
+        // spaces, parentheses and backslashes
+        for (auto i = end + 1; i < text.size() && i <= end + 17; ++i)
+        {
+            auto c = text[i];
+
+            if (c == '(')
+            {
+                return QChar(')') + text.mid(end + 1, i - end - 1) + QChar('"');
+            }
+
+            if (c.isSpace() || c == ')' || c == '\\' || c == '"')
+            {
+                break;
+            }
+        }
+
+        return QString();
+    }
+}
+
+QCXXSyntaxParser::QCXXSyntaxParser() :
+    m_document(nullptr),
+    m_formats({"Comment", "String", "Number", "Preprocessor"}),
+    m_keywords(),
+    m_lines(),
+    m_lexedBlocks(0),
+    m_summaries(),
+    m_leafCount(1)
+{
+    Q_INIT_RESOURCE(qcodeeditor_resources);
+    QFile fl(":/languages/cpp.xml");
+
+    if (!fl.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    QLanguage language(&fl);
+
+    if (!language.isLoaded())
+    {
+        return;
+    }
+
+    for (auto&& key : language.keys())
+    {
+        m_formats.append(key);
+
+        for (auto&& name : language.names(key))
+        {
+            m_keywords.insert(name, m_formats.size() - 1);
+        }
+    }
+}
+
+void QCXXSyntaxParser::reset(const QTextDocument* document)
+{
+    m_document = document;
+    m_lines.clear();
+    m_lexedBlocks = 0;
+
+    if (m_document == nullptr)
+    {
+        buildSummaries();
+        return;
+    }
+
+    m_lines.reserve(m_document->blockCount());
+
+    State state{false, QString()};
+
+    for (auto block = m_document->begin(); block.isValid(); block = block.next())
+    {
+        m_lines.append(lexBlock(block.text(), state));
+        state = m_lines.last().state;
+    }
+
+    m_lexedBlocks = m_lines.size();
+
+    buildSummaries();
+}
+
+QPair<int, int> QCXXSyntaxParser::edit(const QTextDocument* document,
+                                       int position,
+                                       int charsRemoved,
+                                       int charsAdded)
+{
+    Q_UNUSED(charsRemoved)
+
+    if (document != m_document ||
+        document == nullptr ||
+        m_lines.isEmpty())
+    {
+        reset(document);
+        return {-1, -1};
+    }
+
+    // Block numbers before edit aren't changed, number
+    // of blocks tells how many blocks were replaced
+    auto first = document->findBlock(position);
+    auto last = document->findBlock(
+        std::min(position + charsAdded, document->characterCount() - 1)
+    );
+
+    if (!first.isValid() || !last.isValid())
+    {
+        reset(document);
+        return {-1, -1};
+    }
+
+    auto blockDelta = document->blockCount() - m_lines.size();
+    auto firstNumber = first.blockNumber();
+
+    QVector<Line> lines;
+
+    auto state = firstNumber > 0
+        ? m_lines[firstNumber - 1].state
+        : State{false, QString()};
+    auto block = first;
+
+    for (; block.isValid(); block = block.next())
+    {
+        lines.append(lexBlock(block.text(), state));
+        state = lines.last().state;
+
+        auto oldNumber = block.blockNumber() - blockDelta;
+
+        // Text after edit is unchanged, so the rest is
+        // reused as soon as lexer state matches
+        if (block.blockNumber() >= last.blockNumber() &&
+            oldNumber >= firstNumber &&
+            oldNumber < m_lines.size() &&
+            m_lines[oldNumber].state == state)
+        {
+            break;
+        }
+    }
+
+    auto oldEnd = firstNumber + lines.size() - blockDelta;
+
+    std::move(lines.begin(),
+              lines.begin() + std::min(lines.size(), oldEnd - firstNumber),
+              m_lines.begin() + firstNumber);
+
+    if (blockDelta > 0)
+    {
+        m_lines.insert(oldEnd, blockDelta, Line());
+        std::move(lines.end() - blockDelta,
+                  lines.end(),
+                  m_lines.begin() + oldEnd);
+    }
+    else if (blockDelta < 0)
+    {
+        m_lines.remove(firstNumber + lines.size(), -blockDelta);
+    }
+
+    m_lexedBlocks = lines.size();
+
+    // Tree is rebuilt, when blocks are shifted anyway
+    if (blockDelta == 0)
+    {
+        updateSummaries(firstNumber, firstNumber + lines.size());
+    }
+    else
+    {
+        buildSummaries();
+    }
+
+    auto lexedLast = block.isValid() ? block : document->lastBlock();
+
+    if (lexedLast.blockNumber() <= last.blockNumber())
+    {
+        return {-1, -1};
+    }
+
+    // Lexer state was changed after edited blocks
+    return {first.position(), lexedLast.position() + lexedLast.length()};
+}
+
+QVector<QSyntaxParser::Span> QCXXSyntaxParser::spans(int start, int end) const
+{
+    QVector<Span> result;
+
+    if (m_document == nullptr)
+    {
+        return result;
+    }
+
+    for (auto block = m_document->findBlock(start);
+         block.isValid() &&
+         block.position() < end &&
+         block.blockNumber() < m_lines.size();
+         block = block.next())
+    {
+        auto blockPosition = block.position();
+
+        for (auto& token : m_lines[block.blockNumber()].tokens)
+        {
+            auto tokenStart = blockPosition + token.start;
+
+            if (token.format == Bracket ||
+                tokenStart + token.length <= start ||
+                tokenStart >= end)
+            {
+                continue;
+            }
+
+            result.append({tokenStart, token.length, m_formats[token.format]});
+        }
+    }
+
+    return result;
+}
+
+QPair<int, int> QCXXSyntaxParser::parentNode(int start, int end) const
+{
+    if (m_document == nullptr)
+    {
+        return {-1, -1};
+    }
+
+    // Range may end with closing bracket of pair
+    auto last = std::max(start, end - 1);
+
+    auto firstBlock = m_document->findBlock(start);
+    auto lastBlock = m_document->findBlock(last);
+
+    if (!firstBlock.isValid() ||
+        !lastBlock.isValid() ||
+        lastBlock.blockNumber() >= m_lines.size())
+    {
+        return {-1, -1};
+    }
+
+    auto depth = depthBefore(firstBlock.blockNumber());
+    scanDepth(firstBlock, firstBlock.position(), start, &depth);
+
+    auto startDepth = depth;
+    auto minimum = scanDepth(
+        firstBlock,
+        start,
+        firstBlock == lastBlock ? last : lastBlock.position(),
+        &depth
+    );
+
+    // Blocks between range ends are taken from summaries
+    if (firstBlock != lastBlock)
+    {
+        auto summary = rangeSummary(firstBlock.blockNumber() + 1, lastBlock.blockNumber());
+        minimum = std::min(minimum, depth + summary.minimum);
+        depth += summary.delta;
+
+        minimum = std::min(minimum, scanDepth(lastBlock, lastBlock.position(), last, &depth));
+    }
+
+    // The smallest pair encloses the lowest depth of range
+    auto opening = findBracket(start, startDepth, minimum - 1, false);
+    auto closing = findBracket(start, startDepth, minimum - 1, true);
+
+    if (opening < 0 || closing < 0)
+    {
+        return {-1, -1};
+    }
+
+    return {opening, closing + 1};
+}
+
+int QCXXSyntaxParser::lexedBlocks() const
+{
+    return m_lexedBlocks;
+}
+
+bool QCXXSyntaxParser::State::operator==(const State& other) const
+{
+    return comment == other.comment && rawString == other.rawString;
+}
+
+QCXXSyntaxParser::Line QCXXSyntaxParser::lexBlock(const QString& text, const State& state) const
+{
+    Line line{{}, {false, QString()}, 0, 0};
+
+    auto size = text.size();
+    auto i = 0;
+
+    if (state.comment || !state.rawString.isEmpty())
+    {
+        auto closing = state.comment ? QString("*/") : state.rawString;
+        auto format = state.comment ? Comment : String;
+        auto end = text.indexOf(closing);
+
+        if (end < 0)
+        {
+            if (size > 0)
+            {
+                line.tokens.append({0, size, format});
+            }
+
+            line.state = state;
+            return line;
+        }
+
+        line.tokens.append({0, end + closing.size(), format});
+        i = end + closing.size();
+    }
+
+    while (i < size)
+    {
+        auto c = text[i];
+        auto next = i + 1 < size ? text[i + 1] : QChar();
+
+        if (c == '/' && next == '/')
+        {
+            line.tokens.append({i, size - i, Comment});
+            break;
+        }
+
+        if (c == '/' && next == '*')
+        {
+            auto end = text.indexOf("*/", i + 2);
+
+            if (end < 0)
+            {
+                line.tokens.append({i, size - i, Comment});
+                line.state.comment = true;
+                break;
+            }
+
+            line.tokens.append({i, end + 2 - i, Comment});
+            i = end + 2;
+        }
+        else if (c == '"' || c == '\'')
+        {
+            auto end = i + 1;
+
+            // Escaped characters are skipped with backslash
+            while (end < size && text[end] != c)
+            {
+                end += text[end] == '\\' ? 2 : 1;
+            }
+
+            end = std::min(end + 1, size);
+
+            line.tokens.append({i, end - i, String});
+            i = end;
+        }
+        else if (c.isDigit())
+        {
+            auto end = i + 1;
+
+            while (end < size &&
+                   (isWordCharacter(text[end]) ||
+                    text[end] == '.' ||
+                    text[end] == '\''))
+            {
+                ++end;
+            }
+
+            line.tokens.append({i, end - i, Number});
+            i = end;
+        }
+        else if (isWordCharacter(c))
+        {
+            auto end = i + 1;
+
+            while (end < size && isWordCharacter(text[end]))
+            {
+                ++end;
+            }
+
+            auto closing = rawStringClosing(text, i, end);
+
+            if (!closing.isEmpty())
+            {
+                // Quotes and escapes aren't special in raw string
+                auto close = text.indexOf(closing, text.indexOf('(', end) + 1);
+
+                if (close < 0)
+                {
+                    line.tokens.append({i, size - i, String});
+                    line.state.rawString = closing;
+                    break;
+                }
+
+                line.tokens.append({i, close + closing.size() - i, String});
+                i = close + closing.size();
+                continue;
+            }
+
+            auto format = m_keywords.value(text.mid(i, end - i), -1);
+
+            if (format >= 0)
+            {
+                line.tokens.append({i, end - i, format});
+            }
+
+            i = end;
+        }
+        else if (c == '#' && text.leftRef(i).trimmed().isEmpty())
+        {
+            auto end = i + 1;
+
+            while (end < size && isWordCharacter(text[end]))
+            {
+                ++end;
+            }
+
+            line.tokens.append({i, end - i, Preprocessor});
+            i = end;
+        }
+        else
+        {
+            if (QSyntaxBlockData::isBracket(c))
+            {
+                line.tokens.append({i, 1, Bracket});
+                line.depthDelta += QSyntaxBlockData::isOpeningBracket(c) ? 1 : -1;
+                line.minimumDepth = std::min(line.minimumDepth, line.depthDelta);
+            }
+
+            ++i;
+        }
+    }
+
+    return line;
+}
+
+int QCXXSyntaxParser::findBracket(int position, int depth, int target, bool forward) const
+{
+    auto block = m_document->findBlock(position);
+
+    if (!block.isValid() || block.blockNumber() >= m_lines.size())
+    {
+        return -1;
+    }
+
+    auto result = scanBlock(block, position, forward, &depth, target);
+
+    if (result >= 0)
+    {
+        return result;
+    }
+
+    // Depth is at block end going forward and at
+    // block start going backward
+    auto number = forward
+        ? findNextLine(block.blockNumber(), depth, target, &depth)
+        : findPreviousLine(block.blockNumber(), depth, target, &depth);
+
+    if (number < 0)
+    {
+        return -1;
+    }
+
+    block = m_document->findBlockByNumber(number);
+
+    if (forward)
+    {
+        return scanBlock(block, block.position(), true, &depth, target);
+    }
+
+    depth += m_lines[number].depthDelta;
+
+    return scanBlock(block, block.position() + block.length(), false, &depth, target);
+}
+
+int QCXXSyntaxParser::scanBlock(const QTextBlock& block,
+                                int position,
+                                bool forward,
+                                int* depth,
+                                int target) const
+{
+    auto& tokens = m_lines[block.blockNumber()].tokens;
+    auto blockPosition = block.position();
+
+    for (auto i = 0; i < tokens.size(); ++i)
+    {
+        auto& token = tokens[forward ? i : tokens.size() - 1 - i];
+        auto tokenPosition = blockPosition + token.start;
+
+        if (token.format != Bracket ||
+            (forward && tokenPosition < position) ||
+            (!forward && tokenPosition >= position))
+        {
+            continue;
+        }
+
+        auto step = QSyntaxBlockData::isOpeningBracket(
+            m_document->characterAt(tokenPosition)
+        ) ? 1 : -1;
+
+        // Depth after bracket going forward and
+        // before it going backward
+        *depth += forward ? step : -step;
+
+        if (*depth <= target)
+        {
+            return tokenPosition;
+        }
+    }
+
+    return -1;
+}
+
+int QCXXSyntaxParser::scanDepth(const QTextBlock& block, int first, int last, int* depth) const
+{
+    auto minimum = *depth;
+    auto blockPosition = block.position();
+
+    for (auto& token : m_lines[block.blockNumber()].tokens)
+    {
+        auto tokenPosition = blockPosition + token.start;
+
+        if (tokenPosition >= last)
+        {
+            break;
+        }
+
+        if (token.format != Bracket || tokenPosition < first)
+        {
+            continue;
+        }
+
+        *depth += QSyntaxBlockData::isOpeningBracket(
+            m_document->characterAt(tokenPosition)
+        ) ? 1 : -1;
+
+        minimum = std::min(minimum, *depth);
+    }
+
+    return minimum;
+}
+
+int QCXXSyntaxParser::depthBefore(int line) const
+{
+    auto depth = 0;
+
+    // Left siblings on the path to root precede block
+    for (auto node = m_leafCount + line; node > 1; node /= 2)
+    {
+        if (node % 2 == 1)
+        {
+            depth += m_summaries[node - 1].delta;
+        }
+    }
+
+    return depth;
+}
+
+int QCXXSyntaxParser::findNextLine(int line, int depth, int target, int* startDepth) const
+{
+    auto node = m_leafCount + line;
+
+    // Going up until right sibling goes down to target
+    for (;; node /= 2)
+    {
+        if (node == 1)
+        {
+            return -1;
+        }
+
+        if (node % 2 == 1)
+        {
+            continue;
+        }
+
+        auto& sibling = m_summaries[node + 1];
+
+        if (depth + sibling.minimum <= target)
+        {
+            ++node;
+            break;
+        }
+
+        depth += sibling.delta;
+    }
+
+    // Going down to the first such block
+    while (node < m_leafCount)
+    {
+        node *= 2;
+
+        auto& left = m_summaries[node];
+
+        if (depth + left.minimum > target)
+        {
+            depth += left.delta;
+            ++node;
+        }
+    }
+
+    *startDepth = depth;
+
+    return node - m_leafCount;
+}
+
+int QCXXSyntaxParser::findPreviousLine(int line, int depth, int target, int* startDepth) const
+{
+    auto node = m_leafCount + line;
+
+    // Going up until left sibling goes down to target,
+    // depth is kept at the end of node
+    for (;; node /= 2)
+    {
+        if (node == 1)
+        {
+            return -1;
+        }
+
+        if (node % 2 == 0)
+        {
+            continue;
+        }
+
+        auto& sibling = m_summaries[node - 1];
+        auto start = depth - sibling.delta;
+
+        if (start + sibling.minimum <= target)
+        {
+            --node;
+            break;
+        }
+
+        depth = start;
+    }
+
+    // Going down to the last such block
+    while (node < m_leafCount)
+    {
+        node = node * 2 + 1;
+
+        auto& right = m_summaries[node];
+        auto start = depth - right.delta;
+
+        if (start + right.minimum > target)
+        {
+            depth = start;
+            --node;
+        }
+    }
+
+    *startDepth = depth - m_summaries[node].delta;
+
+    return node - m_leafCount;
+}
+
+QCXXSyntaxParser::Summary QCXXSyntaxParser::rangeSummary(int first, int last) const
+{
+    Summary left{0, 0};
+    Summary right{0, 0};
+
+    for (auto l = m_leafCount + first, r = m_leafCount + last; l < r; l /= 2, r /= 2)
+    {
+        if (l % 2 == 1)
+        {
+            left = join(left, m_summaries[l++]);
+        }
+
+        if (r % 2 == 1)
+        {
+            right = join(m_summaries[--r], right);
+        }
+    }
+
+    return join(left, right);
+}
+
+void QCXXSyntaxParser::buildSummaries()
+{
+    m_leafCount = 1;
+
+    while (m_leafCount < m_lines.size())
+    {
+        m_leafCount *= 2;
+    }
+
+    m_summaries.fill({0, 0}, m_leafCount * 2);
+
+    for (auto i = 0; i < m_lines.size(); ++i)
+    {
+        m_summaries[m_leafCount + i] = {m_lines[i].depthDelta, m_lines[i].minimumDepth};
+    }
+
+    for (auto node = m_leafCount - 1; node > 0; --node)
+    {
+        m_summaries[node] = join(m_summaries[node * 2], m_summaries[node * 2 + 1]);
+    }
+}
+
+void QCXXSyntaxParser::updateSummaries(int first, int last)
+{
+    if (first >= last)
+    {
+        return;
+    }
+
+    for (auto i = first; i < last; ++i)
+    {
+        m_summaries[m_leafCount + i] = {m_lines[i].depthDelta, m_lines[i].minimumDepth};
+    }
+
+    // Parents of changed blocks are updated level by level
+    for (auto l = (m_leafCount + first) / 2, r = (m_leafCount + last - 1) / 2;
+         l > 0;
+         l /= 2, r /= 2)
+    {
+        for (auto node = l; node <= r; ++node)
+        {
+            m_summaries[node] = join(m_summaries[node * 2], m_summaries[node * 2 + 1]);
+        }
+    }
+}
+
+QCXXSyntaxParser::Summary QCXXSyntaxParser::join(const Summary& left, const Summary& right)
+{
+    return {left.delta + right.delta, std::min(left.minimum, left.delta + right.minimum)};
+}
@@ -4,7 +4,14 @@
 #include <QCodeEditor>
 #include <QStyleSyntaxHighlighter>
 #include <QFramedTextAttribute>
+#include <QHoverProvider>
 #include <QCXXHighlighter>
+#include <QBracketIndex>
+#include <QSyntaxBlockData>
+#include <QSyntaxTree>
+#include <QTracer>
+#include <QSnippet>
+#include <QCompletionListModel>
 
 
 // Qt
@@ -19,6 +26,20 @@
 #include <QAbstractItemView>
 #include <QShortcut>
 #include <QMimeData>
+#include <QToolTip>
+#include <QHelpEvent>
+#include <QStringList>
+#include <QPainter>
+#include <QTimer>
+#include <QMouseEvent>
+#include <QApplication>
+#include <QClipboard>
+
+// C++ STL
+#include <algorithm>
+#include <utility>
+#include <thread>
+#include <vector>
 
 static QVector<QPair<QString, QString>> parentheses = {
     {"(", ")"},
@@ -28,6 +49,244 @@ static QVector<QPair<QString, QString>> parentheses = {
     {"'", "'"}
 };
 
+static void normalizeLineEndings(QString& text)
+{
+    // QString search is vectorized, most texts have no CR
+    auto first = text.indexOf('\r');
+
+    if (first < 0)
+    {
+        return;
+    }
+
+    auto data = text.data();
+    auto size = text.size();
+    auto out = first;
+
+    for (auto i = first; i < size; ++i)
+    {
+        if (data[i] == '\r')
+        {
+            data[out++] = '\n';
+
+            if (i + 1 < size && data[i + 1] == '\n')
+            {
+                ++i;
+            }
+        }
+        else
+        {
+            data[out++] = data[i];
+        }
+    }
+
+    text.truncate(out);
+}
+
+static int indentationSize(const QString& text)
+{
+    auto size = 0;
+
+    while (size < text.size() &&
+           (text[size] == ' ' || text[size] == '\t'))
+    {
+        ++size;
+    }
+
+    return size;
+}
+
+static bool toggleLineComment(QStringList& lines, const QString& token)
+{
+    auto column = -1;
+    auto commented = true;
+
+    for (auto& line : lines)
+    {
+        auto indentation = indentationSize(line);
+
+        // Blank lines are kept
+        if (indentation == line.size())
+        {
+            continue;
+        }
+
+        column = column < 0 ? indentation : std::min(column, indentation);
+        commented = commented && line.midRef(indentation).startsWith(token);
+    }
+
+    if (column < 0)
+    {
+        return false;
+    }
+
+    for (auto& line : lines)
+    {
+        auto indentation = indentationSize(line);
+
+        if (indentation == line.size())
+        {
+            continue;
+        }
+
+        if (commented)
+        {
+            auto length = token.size();
+
+            // Space after token is added by commenting
+            if (indentation + length < line.size() &&
+                line[indentation + length] == ' ')
+            {
+                ++length;
+            }
+
+            line.remove(indentation, length);
+        }
+        else
+        {
+            // Comments are aligned by the least indented line
+            line.insert(column, token + ' ');
+        }
+    }
+
+    return true;
+}
+
+static bool toggleBlockComment(QString& text, const QPair<QString, QString>& tokens)
+{
+    auto start = 0;
+    auto end = text.size();
+
+    while (start < end && text[start].isSpace())
+    {
+        ++start;
+    }
+
+    while (end > start && text[end - 1].isSpace())
+    {
+        --end;
+    }
+
+    if (start == end)
+    {
+        return false;
+    }
+
+    auto commented = end - start >= tokens.first.size() + tokens.second.size() &&
+                     text.midRef(start, end - start).startsWith(tokens.first) &&
+                     text.midRef(start, end - start).endsWith(tokens.second);
+
+    if (commented)
+    {
+        auto innerStart = start + tokens.first.size();
+        auto innerEnd = end - tokens.second.size();
+
+        // Spaces inside tokens are added by commenting
+        if (innerStart < innerEnd && text[innerStart] == ' ')
+        {
+            ++innerStart;
+        }
+
+        if (innerEnd > innerStart && text[innerEnd - 1] == ' ')
+        {
+            --innerEnd;
+        }
+
+        text = text.left(start) +
+               text.mid(innerStart, innerEnd - innerStart) +
+               text.mid(end);
+    }
+    else
+    {
+        text.insert(end, " " + tokens.second);
+        text.insert(start, tokens.first + " ");
+    }
+
+    return true;
+}
+
+static void parallelSort(QVector<QString>& lines)
+{
+    // Smaller parts aren't worth a thread
+    static const int minimumPart = 1 << 16;
+
+    auto threads = std::min(
+        static_cast<int>(std::max(1u, std::thread::hardware_concurrency())),
+        lines.size() / minimumPart
+    );
+
+    if (threads < 2)
+    {
+        std::sort(lines.begin(), lines.end());
+        return;
+    }
+
+    // Data is detached before threads start
+    auto data = lines.data();
+
+    std::vector<int> bounds;
+    for (auto i = 0; i <= threads; ++i)
+    {
+        bounds.push_back(static_cast<int>(static_cast<qint64>(lines.size()) * i / threads));
+    }
+
+    std::vector<std::thread> workers;
+
+    for (auto i = 0; i < threads; ++i)
+    {
+        auto first = bounds[i];
+        auto last = bounds[i + 1];
+
+        workers.emplace_back([data, first, last]()
+        {
+            std::sort(data + first, data + last);
+        });
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    // Sorted parts are merged pairwise
+    for (auto width = 1; width < threads; width *= 2)
+    {
+        workers.clear();
+
+        for (auto i = 0; i + width < threads; i += 2 * width)
+        {
+            auto first = bounds[i];
+            auto middle = bounds[i + width];
+            auto last = bounds[std::min(i + 2 * width, threads)];
+
+            workers.emplace_back([data, first, middle, last]()
+            {
+                std::inplace_merge(data + first, data + middle, data + last);
+            });
+        }
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+}
+
+static QString severityFormatName(QDiagnostic::Severity severity)
+{
+    switch (severity)
+    {
+    case QDiagnostic::Severity::Error:
+        return "Error";
+    case QDiagnostic::Severity::Warning:
+        return "Warning";
+    case QDiagnostic::Severity::Information:
+        return "Information";
+    }
+
+    return "Error";
+}
+
 QCodeEditor::QCodeEditor(QWidget* widget) :
     QTextEdit(widget),
     m_highlighter(nullptr),
@@ -38,7 +297,47 @@ QCodeEditor::QCodeEditor(QWidget* widget) :
     m_autoIndentation(true),
     m_autoParentheses(true),
     m_replaceTab(true),
-    m_tabReplace(QString(4, ' '))
+    m_tabReplace(QString(4, ' ')),
+    m_parenthesesSearchLimit(0),
+    m_rainbowParentheses(false),
+    m_selectionHistory(),
+    m_diagnostics(),
+    m_inlineHints(),
+    m_hoverProvider(nullptr),
+    m_hoverTimer(new QTimer(this)),
+    m_hoverDelay(500),
+    m_hoverPoint(),
+    m_hoverRequestCounter(0),
+    m_hoverRequest{-1, QString(), -1, -1, QRect(), QString()},
+    m_hoverCache(256),
+    m_largePasteSize(1 << 20),
+    m_highlightTimer(new QTimer(this)),
+    m_undoCoalescing(UndoCoalescing::EditBlock),
+    m_undoTimeWindow(1000),
+    m_undoMemoryLimit(0),
+    m_undoMemoryUsage(0),
+    m_undoLimitPending(false),
+    m_undoStepSizes(),
+    m_undoStepCount(0),
+    m_undoCommandAdded(false),
+    m_contentsRevision(0),
+    m_undoKind(UndoStepKind::None),
+    m_undoSteps(-1),
+    m_undoPosition(-1),
+    m_undoTimer(),
+    m_boxSelection{-1, 0, -1, 0},
+    m_boxDragging(false),
+    m_boxEditing(false),
+    m_wordCompletion(false),
+    m_wordIndex(),
+    m_snippets(),
+    m_snippetStops(),
+    m_snippetNumbers(),
+    m_snippetIndex(-1),
+    m_snippetStart(),
+    m_snippetEnd(),
+    m_tracer(nullptr),
+    m_keystrokeStart(-1)
 {
     initDocumentLayoutHandlers();
     initFont();
@@ -94,12 +393,115 @@ void QCodeEditor::performConnections()
         this,
         &QCodeEditor::onSelectionChanged
     );
+
+    connect(
+        verticalScrollBar(),
+        &QScrollBar::valueChanged,
+        [this](int){ if (m_diagnostics.size()) updateExtraSelection(); }
+    );
+
+    m_hoverTimer->setSingleShot(true);
+
+    m_highlightTimer->setSingleShot(true);
+
+    connect(
+        m_highlightTimer,
+        &QTimer::timeout,
+        this,
+        &QCodeEditor::highlightPendingBlocks
+    );
+
+    connect(
+        m_hoverTimer,
+        &QTimer::timeout,
+        this,
+        &QCodeEditor::requestHover
+    );
+
+    connect(
+        document(),
+        &QTextDocument::contentsChange,
+        [this](int position, int charsRemoved, int charsAdded)
+        {
+            // Highlighting format changes have equal lengths and
+            // keep revision. Typed text may keep length too, but
+            // it changes revision
+            auto revision = document()->revision();
+            auto textChanged = charsRemoved != charsAdded ||
+                               revision != m_contentsRevision;
+
+            m_contentsRevision = revision;
+
+            if (!textChanged)
+            {
+                // Format change may add undo command too
+                if (document()->isUndoRedoEnabled())
+                {
+                    updateUndoMemoryUsage(0);
+                }
+
+                return;
+            }
+
+            if (m_wordCompletion)
+            {
+                m_wordIndex.update(document(), position, charsRemoved, charsAdded);
+            }
+
+            m_diagnostics.shift(position, charsRemoved, charsAdded);
+            m_inlineHints.shift(position, charsRemoved, charsAdded);
+
+            // Lines of rectangular selection may be moved
+            if (!m_boxEditing)
+            {
+                clearBoxSelection();
+            }
+
+            if (document()->isUndoRedoEnabled())
+            {
+                // Inserted text is kept by document until undo
+                // history is cleared, 64 bytes is command estimation
+                updateUndoMemoryUsage(charsAdded * static_cast<qint64>(sizeof(QChar)) + 64);
+                applyUndoMemoryLimit();
+            }
+        }
+    );
+
+    // It's emitted before contents change of new command,
+    // but not for undo, redo and merged keystrokes
+    connect(
+        document(),
+        &QTextDocument::undoCommandAdded,
+        [this]()
+        {
+            m_undoCommandAdded = true;
+        }
+    );
+
+    connect(
+        document(),
+        &QTextDocument::undoAvailable,
+        [this](bool available)
+        {
+            // Document was reset or history was cleared
+            if (!available && document()->availableRedoSteps() == 0)
+            {
+                m_undoMemoryUsage = 0;
+                m_undoStepSizes.clear();
+                m_undoStepCount = 0;
+            }
+        }
+    );
 }
 
 void QCodeEditor::setHighlighter(QStyleSyntaxHighlighter* highlighter)
 {
+    m_highlightTimer->stop();
+
     if (m_highlighter)
     {
+        m_highlighter->setInlineHints(nullptr);
+        m_highlighter->setTracer(nullptr);
         m_highlighter->setDocument(nullptr);
     }
 
@@ -108,7 +510,16 @@ void QCodeEditor::setHighlighter(QStyleSyntaxHighlighter* highlighter)
     if (m_highlighter)
     {
         m_highlighter->setSyntaxStyle(m_syntaxStyle);
+        m_highlighter->setRainbowParentheses(m_rainbowParentheses);
+        m_highlighter->setInlineHints(&m_inlineHints);
+        m_highlighter->setTracer(m_tracer);
         m_highlighter->setDocument(document());
+
+        // Parser is attached to document, that's set
+        if (m_highlighter->parser())
+        {
+            m_highlighter->setParser(m_highlighter->parser());
+        }
     }
 }
 
@@ -164,6 +575,8 @@ void QCodeEditor::updateStyle()
 
 void QCodeEditor::onSelectionChanged()
 {
+    QTracer::Span span(m_tracer, "onSelectionChanged");
+
     auto selected = textCursor().selectedText();
 
     auto cursor = textCursor();
@@ -197,6 +610,11 @@ void QCodeEditor::resizeEvent(QResizeEvent* e)
     QTextEdit::resizeEvent(e);
 
     updateLineGeometry();
+
+    if (m_diagnostics.size())
+    {
+        updateExtraSelection();
+    }
 }
 
 void QCodeEditor::updateLineGeometry()
@@ -248,10 +666,14 @@ void QCodeEditor::handleSelectionQuery(QTextCursor cursor)
 
 void QCodeEditor::updateExtraSelection()
 {
+    QTracer::Span span(m_tracer, "updateExtraSelection");
+
     QList<QTextEdit::ExtraSelection> extra;
 
     highlightCurrentLine(extra);
+    highlightDiagnostics(extra);
     highlightParenthesis(extra);
+    highlightMatchingTag(extra);
 
     setExtraSelections(extra);
 }
@@ -261,444 +683,2809 @@ void QCodeEditor::highlightParenthesis(QList<QTextEdit::ExtraSelection>& extraSe
     auto currentSymbol = charUnderCursor();
     auto prevSymbol = charUnderCursor(-1);
 
-    for (auto& pair : parentheses)
+    auto position = textCursor().position();
+
+    if (QSyntaxBlockData::isOpeningBracket(currentSymbol))
+    {
+        // Bracket after cursor
+    }
+    else if (QSyntaxBlockData::isBracket(prevSymbol) &&
+             !QSyntaxBlockData::isOpeningBracket(prevSymbol))
     {
-        int direction;
+        --position;
+    }
+    else
+    {
+        return;
+    }
 
-        QChar counterSymbol;
-        QChar activeSymbol;
-        auto position = textCursor().position();
+    auto matchPosition = findMatchingParenthesis(position);
 
-        if (pair.first == currentSymbol)
-        {
-            direction = 1;
-            counterSymbol = pair.second[0];
-            activeSymbol = currentSymbol;
-        }
-        else if (pair.second == prevSymbol)
-        {
-            direction = -1;
-            counterSymbol = pair.first[0];
-            activeSymbol = prevSymbol;
-            position--;
-        }
-        else
-        {
-            continue;
-        }
+    if (matchPosition < 0)
+    {
+        return;
+    }
 
-        auto counter = 1;
+    auto isPair =
+        QSyntaxBlockData::pairBracket(document()->characterAt(position)) ==
+        document()->characterAt(matchPosition);
 
-        while (counter != 0 &&
-               position > 0 &&
-               position < (document()->characterCount() - 1))
-        {
-            // Moving position
-            position += direction;
+    ExtraSelection selection{};
 
-            auto character = document()->characterAt(position);
-            // Checking symbol under position
-            if (character == activeSymbol)
-            {
-                ++counter;
-            }
-            else if (character == counterSymbol)
-            {
-                --counter;
-            }
-        }
+    selection.format = m_syntaxStyle->getFormat(
+        isPair ? "Parentheses" : "ParenthesesMismatch"
+    );
 
-        auto format = m_syntaxStyle->getFormat("Parentheses");
+    for (auto selectionPosition : {matchPosition, position})
+    {
+        selection.cursor = QTextCursor(document());
+        selection.cursor.setPosition(selectionPosition);
+        selection.cursor.movePosition(
+            QTextCursor::MoveOperation::Right,
+            QTextCursor::MoveMode::KeepAnchor,
+            1
+        );
 
-        // Found
-        if (counter == 0)
-        {
-            ExtraSelection selection{};
+        extraSelection.append(selection);
+    }
+}
 
-            auto directionEnum =
-                 direction < 0 ?
-                 QTextCursor::MoveOperation::Left
-                 :
-                 QTextCursor::MoveOperation::Right;
+void QCodeEditor::highlightMatchingTag(QList<QTextEdit::ExtraSelection>& extraSelection)
+{
+    if (m_highlighter == nullptr)
+    {
+        return;
+    }
 
-            selection.format = format;
-            selection.cursor = textCursor();
-            selection.cursor.clearSelection();
-            selection.cursor.movePosition(
-                directionEnum,
-                QTextCursor::MoveMode::MoveAnchor,
-                std::abs(textCursor().position() - position)
-            );
+    auto index = m_highlighter->elementIndex();
 
-            selection.cursor.movePosition(
-                QTextCursor::MoveOperation::Right,
-                QTextCursor::MoveMode::KeepAnchor,
-                1
-            );
+    if (index == nullptr ||
+        !index->isComplete(document()))
+    {
+        return;
+    }
 
-            extraSelection.append(selection);
+    auto cursor = textCursor();
+    auto block = cursor.block();
+    auto data = dynamic_cast<QSyntaxBlockData*>(block.userData());
 
-            selection.cursor = textCursor();
-            selection.cursor.clearSelection();
-            selection.cursor.movePosition(
-                directionEnum,
-                QTextCursor::MoveMode::KeepAnchor,
-                1
-            );
+    if (data == nullptr ||
+        data->elementData() == nullptr ||
+        data->elementData()->index() != index)
+    {
+        return;
+    }
 
-            extraSelection.append(selection);
-        }
+    auto positionInBlock = cursor.positionInBlock();
+    auto& elements = data->elementData()->brackets();
 
-        break;
-    }
-}
+    // Searching for the last tag before cursor
+    auto tag = std::upper_bound(
+        elements.begin(),
+        elements.end(),
+        positionInBlock,
+        [](int position, const QSyntaxBlockData::Bracket& element)
+        { return position < element.position; }
+    );
 
-void QCodeEditor::highlightCurrentLine(QList<QTextEdit::ExtraSelection>& extraSelection)
-{
-    if (!isReadOnly())
+    if (tag == elements.begin())
     {
-        QTextEdit::ExtraSelection selection{};
+        return;
+    }
 
-        selection.format = m_syntaxStyle->getFormat("CurrentLine");
-        selection.format.setForeground(QBrush());
-        selection.format.setProperty(QTextFormat::FullWidthSelection, true);
-        selection.cursor = textCursor();
-        selection.cursor.clearSelection();
+    --tag;
 
-        extraSelection.append(selection);
+    auto tagStart = block.position() + tag->position;
+
+    // End of self closing tag has no pair
+    if (document()->characterAt(tagStart) != '<')
+    {
+        return;
     }
-}
 
-void QCodeEditor::paintEvent(QPaintEvent* e)
-{
-    updateLineNumberArea(e->rect());
-    QTextEdit::paintEvent(e);
-}
+    // Cursor has to be inside of tag or right after it
+    for (auto position = tagStart; position + 1 < cursor.position(); ++position)
+    {
+        if (document()->characterAt(position) == '>')
+        {
+            return;
+        }
+    }
+
+    auto match = index->findMatchingBracket(
+        block,
+        tag->position,
+        m_parenthesesSearchLimit
+    );
+
+    if (match < 0 ||
+        document()->characterAt(match) != '<')
+    {
+        return;
+    }
+
+    auto name = findTagName(tagStart);
+    auto matchName = findTagName(match);
+
+    auto isPair = name.second - name.first == matchName.second - matchName.first;
+
+    for (auto i = 0; isPair && i < name.second - name.first; ++i)
+    {
+        isPair = document()->characterAt(name.first + i) ==
+                 document()->characterAt(matchName.first + i);
+    }
+
+    ExtraSelection selection{};
+
+    selection.format = m_syntaxStyle->getFormat(
+        isPair ? "Parentheses" : "ParenthesesMismatch"
+    );
+
+    for (auto& range : {matchName, name})
+    {
+        selection.cursor = QTextCursor(document());
+        selection.cursor.setPosition(range.first);
+        selection.cursor.setPosition(range.second, QTextCursor::MoveMode::KeepAnchor);
+
+        extraSelection.append(selection);
+    }
+}
+
+QPair<int, int> QCodeEditor::findTagName(int position) const
+{
+    auto end = document()->characterCount();
+
+    // Skipping `<`, `/` and spaces
+    ++position;
+
+    while (position < end &&
+           (document()->characterAt(position) == '/' ||
+            document()->characterAt(position) == ' ' ||
+            document()->characterAt(position) == '\t'))
+    {
+        ++position;
+    }
+
+    auto nameEnd = position;
+
+    while (nameEnd < end)
+    {
+        auto character = document()->characterAt(nameEnd);
+
+        if (character.isSpace() ||
+            character == '>' ||
+            character == '/')
+        {
+            break;
+        }
+
+        ++nameEnd;
+    }
+
+    return {position, nameEnd};
+}
+
+int QCodeEditor::findMatchingParenthesis(int position) const
+{
+    // Fast path with highlighter index. It skips brackets
+    // inside strings and comments.
+    if (m_highlighter &&
+        m_highlighter->bracketIndex()->isComplete(document()))
+    {
+        auto block = document()->findBlock(position);
+
+        return m_highlighter->bracketIndex()->findMatchingBracket(
+            block,
+            position - block.position(),
+            m_parenthesesSearchLimit
+        );
+    }
+
+    // Character scanning, if there is no index
+    auto direction = QSyntaxBlockData::isOpeningBracket(
+        document()->characterAt(position)
+    ) ? 1 : -1;
+
+    auto counter = 1;
+    auto blocks = 0;
+    auto end = document()->characterCount();
+
+    for (position += direction;
+         position >= 0 && position < end;
+         position += direction)
+    {
+        auto character = document()->characterAt(position);
+
+        if (character == QChar::ParagraphSeparator &&
+            m_parenthesesSearchLimit > 0 &&
+            ++blocks > m_parenthesesSearchLimit)
+        {
+            return -1;
+        }
+
+        if (!QSyntaxBlockData::isBracket(character))
+        {
+            continue;
+        }
+
+        auto sameDirection =
+            QSyntaxBlockData::isOpeningBracket(character) == (direction > 0);
+
+        counter += sameDirection ? 1 : -1;
+
+        if (counter == 0)
+        {
+            return position;
+        }
+    }
+
+    return -1;
+}
+
+QPair<int, int> QCodeEditor::findEnclosingParentheses(int position) const
+{
+    if (!m_highlighter ||
+        !m_highlighter->bracketIndex()->isComplete(document()))
+    {
+        return {-1, -1};
+    }
+
+    auto block = document()->findBlock(position);
+
+    return m_highlighter->bracketIndex()->findEnclosingBrackets(
+        block,
+        position - block.position()
+    );
+}
+
+void QCodeEditor::jumpToEnclosingParenthesis()
+{
+    auto enclosing = findEnclosingParentheses(textCursor().position());
+
+    if (enclosing.first < 0)
+    {
+        return;
+    }
+
+    auto cursor = textCursor();
+    cursor.setPosition(enclosing.first);
+    setTextCursor(cursor);
+}
+
+void QCodeEditor::selectEnclosingBlock()
+{
+    auto cursor = textCursor();
+    auto enclosing = findEnclosingParentheses(cursor.selectionStart());
+
+    // Block has to contain whole selection
+    while (enclosing.first >= 0 &&
+           enclosing.second >= 0 &&
+           enclosing.second + 1 < cursor.selectionEnd())
+    {
+        enclosing = findEnclosingParentheses(enclosing.first);
+    }
+
+    if (enclosing.first < 0 || enclosing.second < 0)
+    {
+        return;
+    }
+
+    cursor.setPosition(enclosing.first);
+    cursor.setPosition(enclosing.second + 1, QTextCursor::MoveMode::KeepAnchor);
+    setTextCursor(cursor);
+}
+
+void QCodeEditor::expandSelection()
+{
+    auto cursor = textCursor();
+
+    // Selection was changed not by expanding
+    if (!m_selectionHistory.empty() &&
+        !(cursor.anchor() == m_selectionHistory.last().first &&
+          cursor.position() == m_selectionHistory.last().second))
+    {
+        m_selectionHistory.clear();
+    }
+
+    const QBracketIndex* index = nullptr;
+
+    if (m_highlighter &&
+        m_highlighter->bracketIndex()->isComplete(document()))
+    {
+        index = m_highlighter->bracketIndex();
+    }
+
+    const QBracketIndex* elementIndex = nullptr;
+
+    if (m_highlighter &&
+        m_highlighter->elementIndex() &&
+        m_highlighter->elementIndex()->isComplete(document()))
+    {
+        elementIndex = m_highlighter->elementIndex();
+    }
+
+    QSyntaxTree tree(
+        document(),
+        index,
+        m_highlighter ? m_highlighter->parser() : nullptr,
+        elementIndex,
+        m_highlighter
+    );
+
+    auto node = tree.parentNode(cursor.selectionStart(), cursor.selectionEnd());
+
+    if (!node.isValid())
+    {
+        return;
+    }
+
+    if (m_selectionHistory.empty())
+    {
+        m_selectionHistory.append({cursor.anchor(), cursor.position()});
+    }
+
+    cursor.setPosition(node.start);
+    cursor.setPosition(node.end, QTextCursor::MoveMode::KeepAnchor);
+    setTextCursor(cursor);
+
+    // Last entry is current selection
+    m_selectionHistory.append({cursor.anchor(), cursor.position()});
+}
+
+void QCodeEditor::shrinkSelection()
+{
+    auto cursor = textCursor();
+
+    if (m_selectionHistory.size() < 2 ||
+        cursor.anchor() != m_selectionHistory.last().first ||
+        cursor.position() != m_selectionHistory.last().second)
+    {
+        m_selectionHistory.clear();
+        return;
+    }
+
+    m_selectionHistory.removeLast();
+
+    cursor.setPosition(m_selectionHistory.last().first);
+    cursor.setPosition(m_selectionHistory.last().second, QTextCursor::MoveMode::KeepAnchor);
+    setTextCursor(cursor);
+
+    if (m_selectionHistory.size() == 1)
+    {
+        m_selectionHistory.clear();
+    }
+}
+
+void QCodeEditor::indentSelection()
+{
+    QTracer::Span span(m_tracer, "indentSelection");
+
+    auto cursor = textCursor();
+    auto blocks = selectedBlocks(cursor);
+    auto indentation = m_replaceTab ? m_tabReplace : QString("\t");
+
+    // Highlighter and undo stack get one change
+    cursor.beginEditBlock();
+
+    for (auto block = blocks.first; block.isValid(); block = block.next())
+    {
+        if (block.length() > 1)
+        {
+            cursor.setPosition(block.position());
+            cursor.insertText(indentation);
+        }
+
+        if (block == blocks.second)
+        {
+            break;
+        }
+    }
+
+    cursor.endEditBlock();
+
+    selectBlocks(blocks.first, blocks.second);
+}
+
+void QCodeEditor::unindentSelection()
+{
+    QTracer::Span span(m_tracer, "unindentSelection");
+
+    auto cursor = textCursor();
+    auto blocks = selectedBlocks(cursor);
+    auto spaces = std::max(1, m_tabReplace.size());
+
+    cursor.beginEditBlock();
+
+    for (auto block = blocks.first; block.isValid(); block = block.next())
+    {
+        auto position = block.position();
+        auto length = block.length() - 1;
+        auto count = 0;
+
+        if (length > 0 && document()->characterAt(position) == '\t')
+        {
+            count = 1;
+        }
+        else
+        {
+            while (count < spaces &&
+                   count < length &&
+                   document()->characterAt(position + count) == ' ')
+            {
+                ++count;
+            }
+        }
+
+        if (count > 0)
+        {
+            cursor.setPosition(position);
+            cursor.setPosition(position + count, QTextCursor::MoveMode::KeepAnchor);
+            cursor.removeSelectedText();
+        }
+
+        if (block == blocks.second)
+        {
+            break;
+        }
+    }
+
+    cursor.endEditBlock();
+
+    selectBlocks(blocks.first, blocks.second);
+}
+
+void QCodeEditor::reindent()
+{
+    if (m_highlighter == nullptr)
+    {
+        return;
+    }
+
+    QTracer::Span span(m_tracer, "reindent");
+
+    // Number of lines between progress signals
+    static const int progressStep = 4096;
+
+    // Levels of every block are taken from highlighted
+    // blocks, so pending ones are highlighted at once
+    m_highlightTimer->stop();
+    m_highlighter->highlightPendingBlocks();
+
+#if QT_VERSION >= 0x050A00
+    auto tabSpaces = tabStopDistance() / fontMetrics().averageCharWidth();
+#else
+    auto tabSpaces = tabStopWidth() / fontMetrics().averageCharWidth();
+#endif
+
+    auto levels = m_highlighter->indentationLevels(static_cast<int>(tabSpaces));
+    auto unit = m_replaceTab ? m_tabReplace : QString("\t");
+
+    QVector<QString> indentations;
+    QTextCursor cursor(document());
+
+    // Big documents are highlighted in background
+    auto deferred = document()->characterCount() >= m_largePasteSize;
+
+    if (deferred)
+    {
+        m_highlighter->setHighlightingDeferred(true);
+    }
+
+    cursor.beginEditBlock();
+
+    auto number = 0;
+
+    for (auto block = document()->begin();
+         block.isValid() && number < levels.size();
+         block = block.next(), ++number)
+    {
+        if (number % progressStep == 0)
+        {
+            Q_EMIT reindentProgress(number, levels.size());
+        }
+
+        auto level = levels[number];
+
+        if (level < 0)
+        {
+            continue;
+        }
+
+        while (indentations.size() <= level)
+        {
+            indentations.append(unit.repeated(indentations.size()));
+        }
+
+        auto& indentation = indentations[level];
+        auto start = block.position();
+        auto end = start + block.length() - 1;
+        auto position = start;
+        auto unchanged = true;
+
+        for (; position < end; ++position)
+        {
+            auto character = document()->characterAt(position);
+
+            if (character != ' ' && character != '\t')
+            {
+                break;
+            }
+
+            unchanged = unchanged &&
+                position - start < indentation.size() &&
+                indentation[position - start] == character;
+        }
+
+        // Only changed indentation is edited
+        if (unchanged && position - start == indentation.size())
+        {
+            continue;
+        }
+
+        cursor.setPosition(start);
+        cursor.setPosition(position, QTextCursor::MoveMode::KeepAnchor);
+
+        if (indentation.isEmpty())
+        {
+            cursor.removeSelectedText();
+        }
+        else
+        {
+            cursor.insertText(indentation);
+        }
+    }
+
+    cursor.endEditBlock();
+
+    if (deferred)
+    {
+        m_highlighter->setHighlightingDeferred(false);
+        m_highlightTimer->start(0);
+    }
+
+    Q_EMIT reindentProgress(levels.size(), levels.size());
+}
+
+QCodeEditor::CleanupResult QCodeEditor::cleanupWhitespace()
+{
+    QTracer::Span span(m_tracer, "cleanupWhitespace");
+
+    CleanupResult result{0, 0, false};
+
+#if QT_VERSION >= 0x050A00
+    auto tabSpaces = tabStopDistance() / fontMetrics().averageCharWidth();
+#else
+    auto tabSpaces = tabStopWidth() / fontMetrics().averageCharWidth();
+#endif
+
+    tabSpaces = std::max(1, static_cast<int>(tabSpaces));
+
+    // Document is copied once instead of every block text,
+    // line breaks are searched by vectorized QString search.
+    // Raw text keeps non-breaking spaces, which are content
+#if QT_VERSION >= 0x050900
+    auto text = document()->toRawText();
+    auto separator = QChar(QChar::ParagraphSeparator);
+#else
+    auto text = document()->toPlainText();
+    auto separator = QChar('\n');
+#endif
+    auto data = text.constData();
+    auto size = text.size();
+
+    struct Edit
+    {
+        int start;
+        int end;
+        QString text;
+    };
+
+    QVector<Edit> edits;
+
+    for (auto lineStart = 0; lineStart <= size;)
+    {
+        auto lineEnd = text.indexOf(separator, lineStart);
+
+        if (lineEnd < 0)
+        {
+            lineEnd = size;
+        }
+
+        auto contentEnd = lineEnd;
+
+        while (contentEnd > lineStart &&
+               (data[contentEnd - 1] == ' ' || data[contentEnd - 1] == '\t'))
+        {
+            --contentEnd;
+        }
+
+        // Blank lines have trailing whitespaces only
+        if (contentEnd > lineStart)
+        {
+            auto contentStart = lineStart;
+            auto width = 0;
+            auto spaces = 0;
+            auto converted = false;
+
+            for (; data[contentStart] == ' ' || data[contentStart] == '\t'; ++contentStart)
+            {
+                if (data[contentStart] == ' ')
+                {
+                    ++width;
+                    ++spaces;
+
+                    // Tabs are used for every full tab width
+                    converted = converted || (!m_replaceTab && spaces == tabSpaces);
+                }
+                else
+                {
+                    width += tabSpaces - width % tabSpaces;
+
+                    converted = converted || m_replaceTab || spaces > 0;
+                }
+            }
+
+            if (converted)
+            {
+                auto indentation = m_replaceTab
+                    ? QString(width, ' ')
+                    : QString(width / tabSpaces, '\t') + QString(width % tabSpaces, ' ');
+
+                edits.append({lineStart, contentStart, indentation});
+                ++result.reindentedLines;
+            }
+        }
+
+        if (contentEnd < lineEnd)
+        {
+            edits.append({contentEnd, lineEnd, QString()});
+            ++result.trimmedLines;
+        }
+
+        lineStart = lineEnd + 1;
+    }
+
+    if (size > 0 && data[size - 1] != separator)
+    {
+        edits.append({size, size, QString("\n")});
+        result.finalNewlineAdded = true;
+    }
+
+    if (edits.isEmpty())
+    {
+        return result;
+    }
+
+    // Big documents are highlighted in background
+    auto deferred = m_highlighter != nullptr && size >= m_largePasteSize;
+
+    if (deferred)
+    {
+        m_highlightTimer->stop();
+        m_highlighter->setHighlightingDeferred(true);
+    }
+
+    QTextCursor cursor(document());
+    cursor.beginEditBlock();
+
+    // Edits from the end keep positions of previous edits
+    for (auto i = edits.size() - 1; i >= 0; --i)
+    {
+        auto& edit = edits[i];
+
+        cursor.setPosition(edit.start);
+        cursor.setPosition(edit.end, QTextCursor::MoveMode::KeepAnchor);
+
+        if (edit.text.isEmpty())
+        {
+            cursor.removeSelectedText();
+        }
+        else
+        {
+            cursor.insertText(edit.text);
+        }
+    }
+
+    cursor.endEditBlock();
+
+    if (deferred)
+    {
+        m_highlighter->setHighlightingDeferred(false);
+        m_highlightTimer->start(0);
+    }
+
+    return result;
+}
+
+void QCodeEditor::moveLinesUp()
+{
+    auto cursor = textCursor();
+    auto blocks = selectedBlocks(cursor);
+    auto previous = blocks.first.previous();
+
+    if (!previous.isValid())
+    {
+        return;
+    }
+
+    auto lines = blocksText(blocks.first, blocks.second);
+    auto previousText = previous.text();
+
+    lines.append(previousText);
+
+    auto offset = previousText.size() + 1;
+
+    replaceBlocks(
+        previous,
+        blocks.second,
+        lines.join('\n'),
+        cursor.anchor() - offset,
+        cursor.position() - offset
+    );
+}
+
+void QCodeEditor::moveLinesDown()
+{
+    auto cursor = textCursor();
+    auto blocks = selectedBlocks(cursor);
+    auto next = blocks.second.next();
+
+    if (!next.isValid())
+    {
+        return;
+    }
+
+    auto lines = blocksText(blocks.first, blocks.second);
+    auto nextText = next.text();
+
+    lines.prepend(nextText);
+
+    auto offset = nextText.size() + 1;
+
+    replaceBlocks(
+        blocks.first,
+        next,
+        lines.join('\n'),
+        cursor.anchor() + offset,
+        cursor.position() + offset
+    );
+}
+
+void QCodeEditor::duplicateLines()
+{
+    auto cursor = textCursor();
+    auto blocks = selectedBlocks(cursor);
+    auto text = blocksText(blocks.first, blocks.second).join('\n');
+    auto offset = text.size() + 1;
+
+    replaceBlocks(
+        blocks.first,
+        blocks.second,
+        text + '\n' + text,
+        cursor.anchor() + offset,
+        cursor.position() + offset
+    );
+}
+
+void QCodeEditor::sortLines()
+{
+    QTracer::Span span(m_tracer, "sortLines");
+
+    auto blocks = selectedBlocks(textCursor());
+
+    if (blocks.first == blocks.second)
+    {
+        return;
+    }
+
+    // Snapshot of lines is sorted outside of document
+    auto lines = blocksText(blocks.first, blocks.second).toVector();
+
+    parallelSort(lines);
+
+    auto text = QStringList(QList<QString>::fromVector(lines)).join('\n');
+    auto start = blocks.first.position();
+
+    replaceBlocks(
+        blocks.first,
+        blocks.second,
+        text,
+        start,
+        start + text.size()
+    );
+}
+
+void QCodeEditor::joinLines()
+{
+    auto cursor = textCursor();
+    auto blocks = selectedBlocks(cursor);
+
+    if (blocks.first == blocks.second)
+    {
+        blocks.second = blocks.first.next();
+
+        if (!blocks.second.isValid())
+        {
+            return;
+        }
+    }
+
+    auto lines = blocksText(blocks.first, blocks.second);
+    auto text = lines.first();
+
+    for (auto i = 1; i < lines.size(); ++i)
+    {
+        auto line = lines[i].trimmed();
+
+        // Trailing whitespaces are replaced with one space
+        while (!text.isEmpty() && text[text.size() - 1].isSpace())
+        {
+            text.chop(1);
+        }
+
+        if (!text.isEmpty() && !line.isEmpty())
+        {
+            text += ' ';
+        }
+
+        text += line;
+    }
+
+    auto position = blocks.first.position() + text.size();
+
+    replaceBlocks(
+        blocks.first,
+        blocks.second,
+        text,
+        position,
+        position
+    );
+}
+
+void QCodeEditor::deleteLines()
+{
+    auto blocks = selectedBlocks(textCursor());
+    auto start = blocks.first.position();
+    auto end = blocks.second.position() + blocks.second.length();
+
+    // Last block has no line break after it
+    if (!blocks.second.next().isValid())
+    {
+        start = std::max(0, start - 1);
+        --end;
+    }
+
+    auto cursor = textCursor();
+    cursor.setPosition(start);
+    cursor.setPosition(end, QTextCursor::MoveMode::KeepAnchor);
+    cursor.removeSelectedText();
+
+    setTextCursor(cursor);
+}
+
+void QCodeEditor::toggleComment()
+{
+    if (m_highlighter == nullptr || isReadOnly())
+    {
+        return;
+    }
+
+    QTracer::Span span(m_tracer, "toggleComment");
+
+    auto lineComment = m_highlighter->lineComment();
+    auto blockComment = m_highlighter->blockComment();
+
+    auto cursor = textCursor();
+    auto blocks = selectedBlocks(cursor);
+    auto lines = blocksText(blocks.first, blocks.second);
+    auto start = blocks.first.position();
+    auto size = blocks.second.position() + blocks.second.length() - 1 - start;
+
+    // Cursor stays at the same text of it's line
+    auto indentationPosition = start + indentationSize(lines.first());
+
+    QString text;
+
+    if (!lineComment.isEmpty())
+    {
+        if (!toggleLineComment(lines, lineComment))
+        {
+            return;
+        }
+
+        text = lines.join('\n');
+    }
+    else if (!blockComment.first.isEmpty() &&
+             !blockComment.second.isEmpty())
+    {
+        text = lines.join('\n');
+
+        if (!toggleBlockComment(text, blockComment))
+        {
+            return;
+        }
+    }
+    else
+    {
+        return;
+    }
+
+    auto anchor = start;
+    auto position = start + text.size();
+
+    if (!cursor.hasSelection())
+    {
+        position = cursor.position() < indentationPosition
+            ? cursor.position()
+            : std::max(indentationPosition, cursor.position() + text.size() - size);
+
+        anchor = position;
+    }
+    else if (cursor.position() < cursor.anchor())
+    {
+        std::swap(anchor, position);
+    }
+
+    // Whole range is one edit, so it's highlighted once
+    replaceBlocks(blocks.first, blocks.second, text, anchor, position);
+}
+
+void QCodeEditor::highlightDiagnostics(QList<QTextEdit::ExtraSelection>& extraSelection)
+{
+    if (m_diagnostics.size() == 0)
+    {
+        return;
+    }
+
+    auto first = cursorForPosition(QPoint(0, 0)).block();
+    auto last = cursorForPosition(
+        QPoint(viewport()->width(), viewport()->height())
+    ).block();
+
+    auto lastPosition = document()->characterCount() - 1;
+
+    for (auto& diagnostic : m_diagnostics.diagnostics(
+             first.position(),
+             last.position() + last.length()))
+    {
+        QTextEdit::ExtraSelection selection{};
+
+        selection.format = m_syntaxStyle->getFormat(
+            severityFormatName(diagnostic.severity)
+        );
+
+        // Empty diagnostic underlines next character
+        auto start = qBound(0, diagnostic.start, lastPosition);
+        auto end = qBound(0, std::max(diagnostic.end, diagnostic.start + 1), lastPosition);
+
+        selection.cursor = QTextCursor(document());
+        selection.cursor.setPosition(start);
+        selection.cursor.setPosition(end, QTextCursor::MoveMode::KeepAnchor);
+
+        extraSelection.append(selection);
+    }
+}
+
+QString QCodeEditor::diagnosticMessage(const QPoint& point) const
+{
+    auto cursor = cursorForPosition(point);
+    auto position = cursor.position();
+
+    // Cursor is placed at the nearest character border
+    if (cursorRect(cursor).left() > point.x() &&
+        position > cursor.block().position())
+    {
+        --position;
+    }
+
+    QStringList messages;
+
+    for (auto& diagnostic : m_diagnostics.diagnostics(position, position))
+    {
+        if (diagnostic.start == position ||
+            diagnostic.end > position)
+        {
+            messages.append(diagnostic.message);
+        }
+    }
+
+    return messages.join('\n');
+}
+
+void QCodeEditor::highlightCurrentLine(QList<QTextEdit::ExtraSelection>& extraSelection)
+{
+    if (!isReadOnly())
+    {
+        QTextEdit::ExtraSelection selection{};
+
+        selection.format = m_syntaxStyle->getFormat("CurrentLine");
+        selection.format.setForeground(QBrush());
+        selection.format.setProperty(QTextFormat::FullWidthSelection, true);
+        selection.cursor = textCursor();
+        selection.cursor.clearSelection();
+
+        extraSelection.append(selection);
+    }
+}
+
+void QCodeEditor::paintEvent(QPaintEvent* e)
+{
+    {
+        QTracer::Span span(m_tracer, "paintEvent");
+
+        updateLineNumberArea(e->rect());
+        QTextEdit::paintEvent(e);
+
+        paintInlineHints();
+        paintBoxSelection();
+    }
+
+    // Key presses since previous paint end here
+    if (m_tracer && m_keystrokeStart >= 0)
+    {
+        m_tracer->addSpan(
+            "Keystroke to paint",
+            m_keystrokeStart,
+            m_tracer->now(),
+            QTracer::Track::Latency
+        );
+
+        m_keystrokeStart = -1;
+    }
+}
+
+int QCodeEditor::getFirstVisibleBlock()
+{
+    // Detect the first block for which bounding rect - once translated
+    // in absolute coordinated - is contained by the editor's text area
+
+    // Costly way of doing but since "blockBoundingGeometry(...)" doesn't
+    // exists for "QTextEdit"...
+
+    QTextCursor curs = QTextCursor(document());
+    curs.movePosition(QTextCursor::Start);
+    for(int i=0; i < document()->blockCount(); ++i)
+    {
+        QTextBlock block = curs.block();
+
+        QRect r1 = viewport()->geometry();
+        QRect r2 = document()
+            ->documentLayout()
+            ->blockBoundingRect(block)
+            .translated(
+                viewport()->geometry().x(),
+                viewport()->geometry().y() - verticalScrollBar()->sliderPosition()
+            ).toRect();
+
+        if (r1.intersects(r2))
+        {
+            return i;
+        }
+
+        curs.movePosition(QTextCursor::NextBlock);
+    }
+
+    return 0;
+}
+
+bool QCodeEditor::proceedCompleterBegin(QKeyEvent *e)
+{
+    QTracer::Span span(m_tracer, "proceedCompleterBegin");
+
+    if (m_completer &&
+        m_completer->popup()->isVisible())
+    {
+        switch (e->key())
+        {
+        case Qt::Key_Enter:
+        case Qt::Key_Return:
+        case Qt::Key_Escape:
+        case Qt::Key_Tab:
+        case Qt::Key_Backtab:
+            e->ignore();
+            return true; // let the completer do default behavior
+        default:
+            break;
+        }
+    }
+
+    // todo: Replace with modifiable QShortcut
+    auto isShortcut = ((e->modifiers() & Qt::ControlModifier) && e->key() == Qt::Key_Space);
+
+    return !(!m_completer || !isShortcut);
+
+}
+
+void QCodeEditor::proceedCompleterEnd(QKeyEvent *e)
+{
+    QTracer::Span span(m_tracer, "proceedCompleterEnd");
+
+    auto ctrlOrShift = e->modifiers() & (Qt::ControlModifier | Qt::ShiftModifier);
+
+    if (!m_completer ||
+        (ctrlOrShift && e->text().isEmpty()) ||
+        e->key() == Qt::Key_Delete)
+    {
+        return;
+    }
+
+    static QString eow(R"(~!@#$%^&*()_+{}|:"<>?,./;'[]\-=)");
+
+    auto isShortcut = ((e->modifiers() & Qt::ControlModifier) && e->key() == Qt::Key_Space);
+    auto completionPrefix = wordUnderCursor();
+
+    if (!isShortcut &&
+        (e->text().isEmpty() ||
+         completionPrefix.length() < 2 ||
+         eow.contains(e->text().right(1))))
+    {
+        m_completer->popup()->hide();
+        return;
+    }
+
+    auto model = qobject_cast<QCompletionListModel*>(m_completer->model());
+
+    if (model)
+    {
+        // Document words change with every edit
+        model->setCompletionPrefix(
+            completionPrefix,
+            m_wordCompletion
+                ? m_wordIndex.completions(completionPrefix, textCursor().blockNumber(), 64)
+                : QStringList()
+        );
+
+        m_completer->setCompletionPrefix(completionPrefix);
+        m_completer->popup()->setCurrentIndex(m_completer->completionModel()->index(0, 0));
+    }
+    else if (completionPrefix != m_completer->completionPrefix())
+    {
+        m_completer->setCompletionPrefix(completionPrefix);
+        m_completer->popup()->setCurrentIndex(m_completer->completionModel()->index(0, 0));
+    }
+
+    auto cursRect = cursorRect();
+    cursRect.setWidth(
+        m_completer->popup()->sizeHintForColumn(0) +
+        m_completer->popup()->verticalScrollBar()->sizeHint().width()
+    );
+
+    m_completer->complete(cursRect);
+}
+
+void QCodeEditor::keyPressEvent(QKeyEvent* e) {
+  QTracer::Span span(m_tracer, "keyPressEvent");
+
+  // Latency is measured from the first key press before paint
+  if (m_tracer && m_keystrokeStart < 0) {
+    m_keystrokeStart = m_tracer->now();
+  }
+
+  if (hasBoxSelection() && proceedBoxSelection(e)) {
+    return;
+  }
+
+  auto completerSkip = proceedCompleterBegin(e);
+
+  if (!completerSkip) {
+    if (hasActiveSnippet() && proceedSnippet(e)) {
+      return;
+    }
+
+    // Whole keystroke is one undo step, that may be
+    // joined with previous keystroke
+    auto undoKind = undoStepKind(e);
+    auto cursor = textCursor();
+
+    // Snippet mirrors are updated in the same undo step
+    auto mirrorEdit = hasActiveSnippet() &&
+                      undoKind != UndoStepKind::None &&
+                      m_undoCoalescing == UndoCoalescing::EditBlock;
+
+    if (mirrorEdit) {
+      cursor.beginEditBlock();
+    }
+
+    beginUndoStep(cursor, undoKind);
+    auto completerEnd = proceedKeyPress(e);
+
+    if (undoKind != UndoStepKind::None) {
+      updateSnippetMirrors();
+    }
+
+    endUndoStep(cursor, undoKind);
+
+    if (mirrorEdit) {
+      cursor.endEditBlock();
+    }
+
+    if (!completerEnd) {
+      return;
+    }
+  }
+
+  proceedCompleterEnd(e);
+}
+
+QCodeEditor::UndoStepKind QCodeEditor::undoStepKind(QKeyEvent* e) const
+{
+    if (e->key() == Qt::Key_Backspace ||
+        e->key() == Qt::Key_Delete)
+    {
+        return UndoStepKind::Deletion;
+    }
+
+    auto text = e->text();
+
+    // Shortcuts and navigation don't type text
+    if (text.isEmpty() ||
+        (e->modifiers() & Qt::ControlModifier) ||
+        (!text[0].isPrint() && text[0] != '\r' && text[0] != '\t'))
+    {
+        return UndoStepKind::None;
+    }
+
+    if (text[0].isLetterOrNumber() || text[0] == '_')
+    {
+        return UndoStepKind::Word;
+    }
+
+    return UndoStepKind::Separator;
+}
+
+void QCodeEditor::beginUndoStep(QTextCursor& cursor, UndoStepKind kind)
+{
+    if (kind == UndoStepKind::None ||
+        m_undoCoalescing == UndoCoalescing::EditBlock)
+    {
+        return;
+    }
+
+    // Nothing else happened since previous keystroke
+    auto join = m_undoKind != UndoStepKind::None &&
+                document()->availableUndoSteps() == m_undoSteps &&
+                cursor.position() == m_undoPosition &&
+                !cursor.hasSelection();
+
+    if (join && m_undoCoalescing == UndoCoalescing::Word)
+    {
+        // Step ends with separators after word
+        join = (kind == UndoStepKind::Deletion) == (m_undoKind == UndoStepKind::Deletion) &&
+               !(kind == UndoStepKind::Word && m_undoKind == UndoStepKind::Separator);
+    }
+    else if (join && m_undoCoalescing == UndoCoalescing::TimeWindow)
+    {
+        join = !m_undoTimer.hasExpired(m_undoTimeWindow);
+    }
+
+    if (join)
+    {
+        cursor.joinPreviousEditBlock();
+    }
+    else
+    {
+        cursor.beginEditBlock();
+
+        // Time window is measured from step start
+        m_undoTimer.start();
+    }
+}
+
+void QCodeEditor::endUndoStep(QTextCursor& cursor, UndoStepKind kind)
+{
+    if (kind == UndoStepKind::None ||
+        m_undoCoalescing == UndoCoalescing::EditBlock)
+    {
+        return;
+    }
+
+    cursor.endEditBlock();
+
+    m_undoKind = kind;
+    m_undoSteps = document()->availableUndoSteps();
+    m_undoPosition = textCursor().position();
+}
+
+void QCodeEditor::applyUndoMemoryLimit()
+{
+    if (m_undoMemoryLimit <= 0 ||
+        m_undoMemoryUsage <= m_undoMemoryLimit ||
+        m_undoLimitPending)
+    {
+        return;
+    }
+
+    m_undoLimitPending = true;
+
+    // Document is still inside of edit
+    QTimer::singleShot(0, this, [this]()
+    {
+        m_undoLimitPending = false;
+
+        if (m_undoMemoryLimit > 0 &&
+            m_undoMemoryUsage > m_undoMemoryLimit)
+        {
+            // Redo steps stay counted for redo
+            m_undoStepSizes.remove(0, std::min(m_undoStepCount, m_undoStepSizes.size()));
+            m_undoStepCount = 0;
+
+            document()->clearUndoRedoStacks(QTextDocument::UndoStack);
+            m_undoMemoryUsage = 0;
+            m_undoKind = UndoStepKind::None;
+        }
+    });
+}
+
+void QCodeEditor::updateUndoMemoryUsage(qint64 bytes)
+{
+    auto steps = document()->availableUndoSteps();
+    auto added = m_undoCommandAdded;
+
+    m_undoCommandAdded = false;
+
+    if (!added && steps != m_undoStepCount)
+    {
+        // Undo or redo moves between counted steps
+        for (auto i = steps; i < m_undoStepCount && i < m_undoStepSizes.size(); ++i)
+        {
+            m_undoMemoryUsage -= m_undoStepSizes[i];
+        }
+
+        for (auto i = m_undoStepCount; i < steps && i < m_undoStepSizes.size(); ++i)
+        {
+            m_undoMemoryUsage += m_undoStepSizes[i];
+        }
+
+        m_undoStepCount = steps;
+        return;
+    }
+
+    if (steps == 0 || (bytes == 0 && !added))
+    {
+        return;
+    }
+
+    // New step replaces redo steps, joined edit block
+    // and merged keystroke extend top step
+    m_undoStepSizes.resize(std::min(m_undoStepCount, steps));
+    m_undoStepSizes.resize(steps);
+    m_undoStepSizes[steps - 1] += bytes;
+
+    m_undoMemoryUsage += bytes;
+    m_undoStepCount = steps;
+}
+
+bool QCodeEditor::proceedKeyPress(QKeyEvent* e) {
+#if QT_VERSION >= 0x050A00
+  const int defaultIndent = tabStopDistance() / fontMetrics().averageCharWidth();
+#else
+  const int defaultIndent = tabStopWidth() / fontMetrics().averageCharWidth();
+#endif
+
+  auto selection = textCursor();
+
+  // Indentation of selected lines
+  auto indentKey = e->key() == Qt::Key_Tab && e->modifiers() == Qt::NoModifier;
+
+  if (!isReadOnly() &&
+      (indentKey || e->key() == Qt::Key_Backtab) &&
+      selection.hasSelection() &&
+      document()->findBlock(selection.selectionStart()) !=
+          document()->findBlock(selection.selectionEnd())) {
+    if (indentKey) {
+      indentSelection();
+    } else {
+      unindentSelection();
+    }
+    return false;
+  }
+
+  if (m_replaceTab && e->key() == Qt::Key_Tab &&
+      e->modifiers() == Qt::NoModifier) {
+    insertPlainText(m_tabReplace);
+    return false;
+  }
+
+  // Auto indentation
+  int indentationLevel = getIndentationSpaces();
+
+#if QT_VERSION >= 0x050A00
+  int tabCounts =
+      indentationLevel * fontMetrics().averageCharWidth() / tabStopDistance();
+#else
+  int tabCounts =
+      indentationLevel * fontMetrics().averageCharWidth() / tabStopWidth();
+#endif
+
+  auto indentation = m_replaceTab ? QString(indentationLevel, ' ')
+                                  : QString(tabCounts, '\t');
+
+  // Have Qt Edior like behaviour, if {|} and enter is pressed indent the two
+  // parenthesis
+  if (m_autoIndentation && 
+     (e->key() == Qt::Key_Return || e->key() == Qt::Key_Enter) &&
+      charUnderCursor() == '}' && charUnderCursor(-1) == '{') 
+  {
+    QTracer::Span indentationSpan(m_tracer, "autoIndentation");
+
+    auto innerIndentation = m_replaceTab
+        ? QString(indentationLevel + defaultIndent, ' ')
+        : QString(tabCounts + 1, '\t');
+
+    // Whole text is one edit with one cursor placement
+    auto cursor = textCursor();
+    auto position = cursor.position();
+
+    cursor.insertText("\n" + innerIndentation + "\n" + indentation);
+    cursor.setPosition(position + 1 + innerIndentation.size());
+
+    setTextCursor(cursor);
+    return false;
+  }
+
+  // Shortcut for moving line to left
+  if (m_replaceTab && e->key() == Qt::Key_Backtab) {
+    indentationLevel = std::min(indentationLevel, m_tabReplace.size());
+
+    auto cursor = textCursor();
+
+    cursor.movePosition(QTextCursor::MoveOperation::StartOfLine);
+    cursor.movePosition(QTextCursor::MoveOperation::Right,
+                        QTextCursor::MoveMode::KeepAnchor, indentationLevel);
+
+    cursor.removeSelectedText();
+    return false;
+  }
+
+  // Token is taken before typed character is highlighted
+  auto token = tokenSpanUnderCursor();
+  auto positionInBlock = textCursor().positionInBlock();
+
+  auto autoIndentation = m_autoIndentation &&
+      (e->key() == Qt::Key_Return || e->key() == Qt::Key_Enter);
+
+  if (!m_autoParentheses ||
+      !proceedAutoParentheses(e, token, positionInBlock)) {
+    auto cursor = textCursor();
+
+    // Line break and indentation are one document change
+    if (autoIndentation) {
+      cursor.beginEditBlock();
+    }
+
+    {
+      QTracer::Span textEditSpan(m_tracer, "QTextEdit::keyPressEvent");
+
+      QTextEdit::keyPressEvent(e);
+    }
+
+    if (autoIndentation) {
+      QTracer::Span indentationSpan(m_tracer, "autoIndentation");
+
+      insertPlainText(indentation);
+      cursor.endEditBlock();
+    }
+  }
+
+  return true;
+}
+
+void QCodeEditor::setAutoIndentation(bool enabled)
+{
+    m_autoIndentation = enabled;
+}
+
+bool QCodeEditor::autoIndentation() const
+{
+    return m_autoIndentation;
+}
+
+void QCodeEditor::setAutoParentheses(bool enabled)
+{
+    m_autoParentheses = enabled;
+}
+
+bool QCodeEditor::autoParentheses() const
+{
+    return m_autoParentheses;
+}
+
+void QCodeEditor::setTabReplace(bool enabled)
+{
+    m_replaceTab = enabled;
+}
+
+bool QCodeEditor::tabReplace() const
+{
+    return m_replaceTab;
+}
+
+void QCodeEditor::setTabReplaceSize(int val)
+{
+    m_tabReplace.clear();
+
+    m_tabReplace.fill(' ', val);
+}
+
+int QCodeEditor::tabReplaceSize() const
+{
+    return m_tabReplace.size();
+}
+
+void QCodeEditor::setRainbowParentheses(bool enabled)
+{
+    if (m_rainbowParentheses == enabled)
+    {
+        return;
+    }
+
+    m_rainbowParentheses = enabled;
+
+    if (m_highlighter)
+    {
+        m_highlighter->setRainbowParentheses(m_rainbowParentheses);
+        m_highlighter->rehighlight();
+    }
+}
+
+bool QCodeEditor::rainbowParentheses() const
+{
+    return m_rainbowParentheses;
+}
+
+void QCodeEditor::setParenthesesSearchLimit(int blocks)
+{
+    m_parenthesesSearchLimit = std::max(0, blocks);
+}
+
+int QCodeEditor::parenthesesSearchLimit() const
+{
+    return m_parenthesesSearchLimit;
+}
+
+void QCodeEditor::setCompleter(QCompleter *completer)
+{
+    if (m_completer)
+    {
+        disconnect(m_completer, nullptr, this, nullptr);
+    }
+
+    m_completer = completer;
+
+    if (!m_completer)
+    {
+        return;
+    }
+
+    m_completer->setWidget(this);
+
+    // Model filters rows by itself
+    m_completer->setCompletionMode(
+        qobject_cast<QCompletionListModel*>(m_completer->model())
+            ? QCompleter::CompletionMode::UnfilteredPopupCompletion
+            : QCompleter::CompletionMode::PopupCompletion
+    );
+
+    connect(
+        m_completer,
+        QOverload<const QString&>::of(&QCompleter::activated),
+        this,
+        &QCodeEditor::insertCompletion
+    );
+}
+
+bool QCodeEditor::viewportEvent(QEvent* event)
+{
+    if (m_hoverProvider)
+    {
+        if (event->type() == QEvent::Leave)
+        {
+            m_hoverTimer->stop();
+            cancelHover();
+        }
+
+        // Diagnostics are shown with hover
+        if (event->type() == QEvent::ToolTip)
+        {
+            return true;
+        }
+    }
+
+    if (event->type() == QEvent::ToolTip &&
+        m_diagnostics.size())
+    {
+        auto helpEvent = static_cast<QHelpEvent*>(event);
+        auto message = diagnosticMessage(helpEvent->pos());
+
+        if (message.isEmpty())
+        {
+            QToolTip::hideText();
+            event->ignore();
+        }
+        else
+        {
+            QToolTip::showText(helpEvent->globalPos(), message, viewport());
+        }
+
+        return true;
+    }
+
+    return QTextEdit::viewportEvent(event);
+}
+
+void QCodeEditor::mouseMoveEvent(QMouseEvent* e)
+{
+    if (m_boxDragging)
+    {
+        auto block = cursorForPosition(e->pos()).block();
+
+        m_boxSelection.block = block.blockNumber();
+        m_boxSelection.column = columnAt(block, e->pos().x());
+
+        viewport()->update();
+        return;
+    }
+
+    QTextEdit::mouseMoveEvent(e);
+
+    if (m_hoverProvider == nullptr)
+    {
+        return;
+    }
+
+    // Tooltip or request stays while mouse is inside of hovered word
+    if (m_hoverRequest.rect.contains(e->pos()) &&
+        (QToolTip::isVisible() || m_hoverRequest.id >= 0))
+    {
+        return;
+    }
+
+    m_hoverPoint = e->pos();
+
+    cancelHover();
+
+    m_hoverTimer->start(m_hoverDelay);
+}
+
+void QCodeEditor::mousePressEvent(QMouseEvent* e)
+{
+    if (e->button() == Qt::LeftButton &&
+        (e->modifiers() & Qt::AltModifier))
+    {
+        auto block = cursorForPosition(e->pos()).block();
+
+        m_boxSelection = {
+            block.blockNumber(),
+            columnAt(block, e->pos().x()),
+            block.blockNumber(),
+            columnAt(block, e->pos().x())
+        };
+        m_boxDragging = true;
+
+        auto cursor = textCursor();
+        cursor.setPosition(
+            block.position() + std::min(m_boxSelection.column, block.length() - 1)
+        );
+        setTextCursor(cursor);
+
+        viewport()->update();
+        return;
+    }
+
+    clearBoxSelection();
+
+    QTextEdit::mousePressEvent(e);
+}
+
+void QCodeEditor::mouseReleaseEvent(QMouseEvent* e)
+{
+    if (m_boxDragging)
+    {
+        m_boxDragging = false;
+        return;
+    }
+
+    QTextEdit::mouseReleaseEvent(e);
+}
+
+void QCodeEditor::focusInEvent(QFocusEvent *e)
+{
+    if (m_completer)
+    {
+        m_completer->setWidget(this);
+    }
+
+    QTextEdit::focusInEvent(e);
+}
+
+void QCodeEditor::insertCompletion(QString s)
+{
+    if (m_completer->widget() != this)
+    {
+        return;
+    }
+
+    auto tc = textCursor();
+    tc.select(QTextCursor::SelectionType::WordUnderCursor);
+
+    if (m_snippets.contains(s))
+    {
+        setTextCursor(tc);
+        insertSnippet(m_snippets.value(s));
+        return;
+    }
+
+    tc.insertText(s);
+    setTextCursor(tc);
+}
+
+QCompleter *QCodeEditor::completer() const
+{
+    return m_completer;
+}
+
+void QCodeEditor::setDiagnostics(QVector<QDiagnostic> diagnostics)
+{
+    m_diagnostics.setDiagnostics(std::move(diagnostics));
+
+    updateExtraSelection();
+}
+
+void QCodeEditor::clearDiagnostics()
+{
+    m_diagnostics.clear();
+
+    updateExtraSelection();
+}
+
+QVector<QDiagnostic> QCodeEditor::diagnostics() const
+{
+    return m_diagnostics.diagnostics();
+}
+
+void QCodeEditor::setInlineHints(QVector<QInlineHint> hints)
+{
+    auto previous = m_inlineHints.hints();
+
+    m_inlineHints.setHints(std::move(hints), fontMetrics());
+
+    rehighlightInlineHints(previous);
+    rehighlightInlineHints(m_inlineHints.hints());
+
+    viewport()->update();
+}
+
+void QCodeEditor::clearInlineHints()
+{
+    auto previous = m_inlineHints.hints();
+
+    m_inlineHints.clear();
+
+    rehighlightInlineHints(previous);
+
+    viewport()->update();
+}
+
+QVector<QInlineHint> QCodeEditor::inlineHints() const
+{
+    return m_inlineHints.hints();
+}
+
+void QCodeEditor::rehighlightInlineHints(const QVector<QInlineHint>& hints)
+{
+    if (m_highlighter == nullptr)
+    {
+        return;
+    }
+
+    auto blockNumber = -1;
+
+    for (auto& hint : hints)
+    {
+        auto block = document()->findBlock(hint.position);
+
+        if (!block.isValid() ||
+            block.blockNumber() == blockNumber)
+        {
+            continue;
+        }
+
+        blockNumber = block.blockNumber();
+
+        m_highlighter->rehighlightBlock(block);
+    }
+}
+
+bool QCodeEditor::hasBoxSelection() const
+{
+    return m_boxSelection.anchorBlock >= 0;
+}
+
+QString QCodeEditor::boxSelectedText() const
+{
+    if (!hasBoxSelection())
+    {
+        return QString();
+    }
+
+    auto first = std::min(m_boxSelection.anchorColumn, m_boxSelection.column);
+    auto last = std::max(m_boxSelection.anchorColumn, m_boxSelection.column);
+
+    QStringList lines;
+
+    for (auto block = document()->findBlockByNumber(
+             std::min(m_boxSelection.anchorBlock, m_boxSelection.block));
+         block.isValid() &&
+         block.blockNumber() <= std::max(m_boxSelection.anchorBlock, m_boxSelection.block);
+         block = block.next())
+    {
+        lines.append(block.text().mid(first, last - first));
+    }
+
+    return lines.join('\n');
+}
+
+void QCodeEditor::clearBoxSelection()
+{
+    if (!hasBoxSelection())
+    {
+        return;
+    }
+
+    m_boxSelection = {-1, 0, -1, 0};
+    m_boxDragging = false;
+
+    viewport()->update();
+}
+
+bool QCodeEditor::proceedBoxSelection(QKeyEvent* e)
+{
+    QTracer::Span span(m_tracer, "proceedBoxSelection");
+
+    auto first = std::min(m_boxSelection.anchorColumn, m_boxSelection.column);
+    auto last = std::max(m_boxSelection.anchorColumn, m_boxSelection.column);
+
+    if (e->key() == Qt::Key_Escape)
+    {
+        clearBoxSelection();
+        return true;
+    }
+
+    if (e->matches(QKeySequence::Copy) ||
+        e->matches(QKeySequence::Cut))
+    {
+        QApplication::clipboard()->setText(boxSelectedText());
+
+        if (e->matches(QKeySequence::Cut) && !isReadOnly())
+        {
+            replaceBoxText(first, last, {QString()});
+        }
+
+        return true;
+    }
+
+    if (isReadOnly())
+    {
+        return false;
+    }
+
+    if (e->matches(QKeySequence::Paste))
+    {
+        paste();
+        return true;
+    }
+
+    if (e->key() == Qt::Key_Backspace ||
+        e->key() == Qt::Key_Delete)
+    {
+        // Empty selection removes character of every line
+        if (first == last)
+        {
+            if (e->key() == Qt::Key_Backspace)
+            {
+                first = std::max(0, first - 1);
+            }
+            else
+            {
+                ++last;
+            }
+        }
+
+        replaceBoxText(first, last, {QString()});
+        return true;
+    }
+
+    auto text = e->text();
+
+    if (!text.isEmpty() &&
+        text[0].isPrint() &&
+        !(e->modifiers() & Qt::ControlModifier))
+    {
+        replaceBoxText(first, last, {text});
+        return true;
+    }
+
+    // Navigation finishes rectangular selection
+    clearBoxSelection();
+
+    return false;
+}
+
+void QCodeEditor::replaceBoxText(int first, int last, const QStringList& lines)
+{
+    auto firstBlock = std::min(m_boxSelection.anchorBlock, m_boxSelection.block);
+    auto lastBlock = std::max(m_boxSelection.anchorBlock, m_boxSelection.block);
+    auto width = 0;
+
+    for (auto& line : lines)
+    {
+        width = std::max(width, line.size());
+    }
+
+    m_boxEditing = true;
+
+    QTextCursor cursor(document());
+
+    // Highlighter and undo stack get one change
+    cursor.beginEditBlock();
+
+    auto index = 0;
+
+    for (auto block = document()->findBlockByNumber(firstBlock);
+         block.isValid() && block.blockNumber() <= lastBlock;
+         block = block.next(), ++index)
+    {
+        auto& line = lines.size() == 1 ? lines.first() : lines[index];
+        auto length = block.length() - 1;
+
+        // Nothing to remove and nothing to insert
+        if (first >= length && line.isEmpty())
+        {
+            continue;
+        }
+
+        cursor.setPosition(block.position() + std::min(first, length));
+        cursor.setPosition(
+            block.position() + std::min(last, length),
+            QTextCursor::MoveMode::KeepAnchor
+        );
+
+        if (line.isEmpty())
+        {
+            cursor.removeSelectedText();
+        }
+        else
+        {
+            cursor.insertText(QString(std::max(0, first - length), ' ') + line);
+        }
+    }
 
-int QCodeEditor::getFirstVisibleBlock()
+    cursor.endEditBlock();
+
+    m_boxEditing = false;
+
+    auto column = first + width;
+
+    m_boxSelection.anchorColumn = column;
+    m_boxSelection.column = column;
+
+    auto block = document()->findBlockByNumber(m_boxSelection.block);
+
+    if (block.isValid())
+    {
+        auto textCursor = this->textCursor();
+        textCursor.setPosition(block.position() + std::min(column, block.length() - 1));
+        setTextCursor(textCursor);
+    }
+
+    viewport()->update();
+}
+
+int QCodeEditor::columnAt(const QTextBlock& block, int x) const
 {
-    // Detect the first block for which bounding rect - once translated
-    // in absolute coordinated - is contained by the editor's text area
+    auto charWidth = std::max(1, fontMetrics().averageCharWidth());
+    auto left = cursorRect(QTextCursor(block)).left();
 
-    // Costly way of doing but since "blockBoundingGeometry(...)" doesn't
-    // exists for "QTextEdit"...
+    return std::max(0, (x - left + charWidth / 2) / charWidth);
+}
 
-    QTextCursor curs = QTextCursor(document());
-    curs.movePosition(QTextCursor::Start);
-    for(int i=0; i < document()->blockCount(); ++i)
+void QCodeEditor::paintBoxSelection()
+{
+    if (!hasBoxSelection())
     {
-        QTextBlock block = curs.block();
+        return;
+    }
 
-        QRect r1 = viewport()->geometry();
-        QRect r2 = document()
-            ->documentLayout()
-            ->blockBoundingRect(block)
-            .translated(
-                viewport()->geometry().x(),
-                viewport()->geometry().y() - verticalScrollBar()->sliderPosition()
-            ).toRect();
+    // Only visible lines of selection are painted
+    auto first = std::max(
+        cursorForPosition(QPoint(0, 0)).block().blockNumber(),
+        std::min(m_boxSelection.anchorBlock, m_boxSelection.block)
+    );
+    auto last = std::min(
+        cursorForPosition(QPoint(viewport()->width(), viewport()->height())).block().blockNumber(),
+        std::max(m_boxSelection.anchorBlock, m_boxSelection.block)
+    );
+
+    auto charWidth = fontMetrics().averageCharWidth();
+    auto firstColumn = std::min(m_boxSelection.anchorColumn, m_boxSelection.column);
+    auto lastColumn = std::max(m_boxSelection.anchorColumn, m_boxSelection.column);
+
+    auto color = m_syntaxStyle->getFormat("Selection").background().color();
+
+    // Selection is painted over text
+    color.setAlpha(128);
+
+    QPainter painter(viewport());
+
+    for (auto block = document()->findBlockByNumber(first);
+         block.isValid() && block.blockNumber() <= last;
+         block = block.next())
+    {
+        auto rect = cursorRect(QTextCursor(block));
+        auto height = static_cast<int>(
+            document()->documentLayout()->blockBoundingRect(block).height()
+        );
+
+        QRect boxRect(
+            rect.left() + firstColumn * charWidth,
+            rect.top(),
+            std::max(1, (lastColumn - firstColumn) * charWidth),
+            height
+        );
+
+        if (firstColumn == lastColumn)
+        {
+            // Caret of every line
+            painter.fillRect(boxRect, palette().text());
+        }
+        else
+        {
+            painter.fillRect(boxRect, color);
+        }
+    }
+}
+
+void QCodeEditor::setWordCompletion(bool enabled)
+{
+    m_wordCompletion = enabled;
+
+    if (m_wordCompletion)
+    {
+        m_wordIndex.rebuild(document());
+    }
+    else
+    {
+        m_wordIndex.clear();
+    }
+}
+
+bool QCodeEditor::wordCompletion() const
+{
+    return m_wordCompletion;
+}
+
+void QCodeEditor::setSnippets(const QHash<QString, QString>& snippets)
+{
+    m_snippets = snippets;
+}
+
+const QHash<QString, QString>& QCodeEditor::snippets() const
+{
+    return m_snippets;
+}
+
+bool QCodeEditor::hasActiveSnippet() const
+{
+    return m_snippetIndex >= 0;
+}
+
+void QCodeEditor::insertSnippet(const QString& snippet)
+{
+    QTracer::Span span(m_tracer, "insertSnippet");
+
+    clearSnippet();
+
+    QSnippet parsed(snippet);
+
+    auto cursor = textCursor();
+    auto blockText = document()->findBlock(cursor.selectionStart()).text();
+
+    auto indentationSize = 0;
+
+    while (indentationSize < blockText.size() &&
+           (blockText[indentationSize] == ' ' || blockText[indentationSize] == '\t'))
+    {
+        ++indentationSize;
+    }
+
+    // Following lines get indentation of current line
+    auto text = parsed.text();
+    text.replace('\n', "\n" + blockText.left(indentationSize));
+
+    auto toText = [&parsed, indentationSize](int offset)
+    {
+        return offset + indentationSize * parsed.text().leftRef(offset).count('\n');
+    };
+
+    cursor.beginEditBlock();
+    cursor.removeSelectedText();
+
+    auto position = cursor.position();
+
+    cursor.insertText(text);
+    cursor.endEditBlock();
+
+    setTextCursor(cursor);
+
+    QVector<int> numbers;
+
+    for (auto& stop : parsed.tabStops())
+    {
+        SnippetStop snippetStop{stop.number, QTextCursor(document()), QTextCursor(document())};
+
+        snippetStop.start.setPosition(position + toText(stop.start));
+        snippetStop.end.setPosition(position + toText(stop.start + stop.length));
+
+        m_snippetStops.append(snippetStop);
+
+        if (stop.number > 0 && !numbers.contains(stop.number))
+        {
+            numbers.append(stop.number);
+        }
+    }
+
+    std::sort(numbers.begin(), numbers.end());
+
+    // Final position is the last one
+    numbers.append(0);
+
+    m_snippetNumbers = numbers;
+    m_snippetStart = QTextCursor(document());
+    m_snippetStart.setPosition(position);
+    m_snippetStart.setKeepPositionOnInsert(true);
+    m_snippetEnd = QTextCursor(document());
+    m_snippetEnd.setPosition(position + text.size());
+
+    selectSnippetStop(0);
+}
+
+void QCodeEditor::clearSnippet()
+{
+    m_snippetStops.clear();
+    m_snippetNumbers.clear();
+    m_snippetIndex = -1;
+    m_snippetStart = QTextCursor();
+    m_snippetEnd = QTextCursor();
+}
+
+bool QCodeEditor::proceedSnippet(QKeyEvent* e)
+{
+    if (e->key() == Qt::Key_Escape)
+    {
+        clearSnippet();
+        return false;
+    }
+
+    auto forward = e->key() == Qt::Key_Tab && e->modifiers() == Qt::NoModifier;
+
+    if (!forward && e->key() != Qt::Key_Backtab)
+    {
+        return false;
+    }
+
+    auto cursor = textCursor();
+
+    // Cursor has left snippet, Tab works as usual
+    if (cursor.selectionStart() < m_snippetStart.position() ||
+        cursor.selectionEnd() > m_snippetEnd.position())
+    {
+        clearSnippet();
+        return false;
+    }
+
+    // Last index is final position, so next one always exists
+    selectSnippetStop(forward ? m_snippetIndex + 1 : std::max(0, m_snippetIndex - 1));
+    return true;
+}
+
+void QCodeEditor::selectSnippetStop(int index)
+{
+    m_snippetIndex = index;
+
+    auto number = m_snippetNumbers[index];
+
+    // Text typed at start belongs to current tab stop
+    // and moves adjacent tab stops
+    for (auto& stop : m_snippetStops)
+    {
+        stop.start.setKeepPositionOnInsert(stop.number == number);
+    }
+
+    for (auto& stop : m_snippetStops)
+    {
+        if (stop.number == number)
+        {
+            auto cursor = textCursor();
+
+            cursor.setPosition(stop.start.position());
+            cursor.setPosition(stop.end.position(), QTextCursor::MoveMode::KeepAnchor);
+
+            setTextCursor(cursor);
+            break;
+        }
+    }
+
+    // Navigation ends at final position
+    if (number == 0)
+    {
+        clearSnippet();
+    }
+}
+
+void QCodeEditor::updateSnippetMirrors()
+{
+    if (!hasActiveSnippet())
+    {
+        return;
+    }
+
+    QTracer::Span span(m_tracer, "updateSnippetMirrors");
+
+    auto number = m_snippetNumbers[m_snippetIndex];
+    auto found = false;
+    QString text;
+
+    for (auto& stop : m_snippetStops)
+    {
+        if (stop.number != number)
+        {
+            continue;
+        }
+
+        QTextCursor range(document());
+        range.setPosition(stop.start.position());
+        range.setPosition(stop.end.position(), QTextCursor::MoveMode::KeepAnchor);
+
+        // The first tab stop is edited one
+        if (!found)
+        {
+            found = true;
+            text = range.selectedText();
+            continue;
+        }
+
+        // Start cursor stays, end cursor moves after text
+        if (range.selectedText() != text)
+        {
+            range.insertText(text);
+        }
+    }
+}
+
+void QCodeEditor::paintInlineHints()
+{
+    if (m_highlighter == nullptr ||
+        m_inlineHints.size() == 0)
+    {
+        return;
+    }
+
+    auto first = cursorForPosition(QPoint(0, 0)).block();
+    auto last = cursorForPosition(
+        QPoint(viewport()->width(), viewport()->height())
+    ).block();
+
+    auto hintFormat = m_syntaxStyle->getFormat("InlineHint");
+
+    QPainter painter(viewport());
+    painter.setFont(font());
+
+    for (auto& entry : m_inlineHints.hints(
+             first.position(),
+             last.position() + last.length()))
+    {
+        QTextCursor cursor(document());
+        cursor.setPosition(
+            qBound(0, entry.hint.position, document()->characterCount() - 1)
+        );
+
+        auto rect = cursorRect(cursor);
+        auto left = rect.left();
+
+        if (cursor.positionInBlock() > 0)
+        {
+            // Space is reserved after previous character
+            left -= entry.width;
+        }
+        else if (cursor.block().length() > 1)
+        {
+            // There is no space at start of non empty block
+            continue;
+        }
+
+        QRect hintRect(left, rect.top(), entry.width, rect.height());
+
+        if (hintFormat.hasProperty(QTextFormat::BackgroundBrush))
+        {
+            painter.fillRect(hintRect, hintFormat.background());
+        }
+
+        painter.setPen(hintFormat.foreground().color());
+        painter.drawText(hintRect, Qt::AlignCenter, entry.hint.text);
+    }
+}
+
+void QCodeEditor::setHoverProvider(QHoverProvider* provider)
+{
+    if (m_hoverProvider)
+    {
+        disconnect(
+            m_hoverProvider,
+            &QHoverProvider::hoverReady,
+            this,
+            &QCodeEditor::onHoverReady
+        );
+    }
+
+    cancelHover();
+    m_hoverCache.clear();
+
+    m_hoverProvider = provider;
+
+    if (m_hoverProvider)
+    {
+        connect(
+            m_hoverProvider,
+            &QHoverProvider::hoverReady,
+            this,
+            &QCodeEditor::onHoverReady
+        );
+    }
+
+    viewport()->setMouseTracking(m_hoverProvider != nullptr);
+}
+
+QHoverProvider* QCodeEditor::hoverProvider() const
+{
+    return m_hoverProvider;
+}
+
+void QCodeEditor::setHoverDelay(int msec)
+{
+    m_hoverDelay = msec;
+}
+
+int QCodeEditor::hoverDelay() const
+{
+    return m_hoverDelay;
+}
+
+void QCodeEditor::setTracer(QTracer* tracer)
+{
+    m_tracer = tracer;
+    m_keystrokeStart = -1;
+
+    if (m_highlighter)
+    {
+        m_highlighter->setTracer(m_tracer);
+    }
+}
+
+QTracer* QCodeEditor::tracer() const
+{
+    return m_tracer;
+}
+
+void QCodeEditor::setLargePasteSize(int size)
+{
+    m_largePasteSize = size;
+}
+
+int QCodeEditor::largePasteSize() const
+{
+    return m_largePasteSize;
+}
+
+void QCodeEditor::setUndoCoalescing(UndoCoalescing coalescing)
+{
+    m_undoCoalescing = coalescing;
+    m_undoKind = UndoStepKind::None;
+}
+
+QCodeEditor::UndoCoalescing QCodeEditor::undoCoalescing() const
+{
+    return m_undoCoalescing;
+}
+
+void QCodeEditor::setUndoTimeWindow(int msec)
+{
+    m_undoTimeWindow = msec;
+}
+
+int QCodeEditor::undoTimeWindow() const
+{
+    return m_undoTimeWindow;
+}
+
+void QCodeEditor::setUndoMemoryLimit(qint64 bytes)
+{
+    m_undoMemoryLimit = bytes;
+
+    applyUndoMemoryLimit();
+}
+
+qint64 QCodeEditor::undoMemoryLimit() const
+{
+    return m_undoMemoryLimit;
+}
+
+qint64 QCodeEditor::undoMemoryUsage() const
+{
+    return m_undoMemoryUsage;
+}
+
+void QCodeEditor::requestHover()
+{
+    auto message = diagnosticMessage(m_hoverPoint);
+
+    auto cursor = cursorForPosition(m_hoverPoint);
+    cursor.select(QTextCursor::SelectionType::WordUnderCursor);
+
+    auto word = cursor.selectedText();
+
+    // Cursor is placed near mouse, so word may be aside
+    QTextCursor wordStart(document());
+    wordStart.setPosition(cursor.selectionStart());
 
-        if (r1.intersects(r2))
+    QTextCursor wordEnd(document());
+    wordEnd.setPosition(cursor.selectionEnd());
+
+    auto startRect = cursorRect(wordStart);
+    auto endRect = cursorRect(wordEnd);
+
+    QRect rect(
+        QPoint(startRect.left(), startRect.top()),
+        QPoint(endRect.left(), startRect.bottom())
+    );
+
+    if (word.trimmed().isEmpty() ||
+        !rect.contains(m_hoverPoint))
+    {
+        m_hoverRequest.rect = QRect();
+
+        if (!message.isEmpty())
         {
-            return i;
+            QToolTip::showText(viewport()->mapToGlobal(m_hoverPoint), message, viewport());
         }
 
-        curs.movePosition(QTextCursor::NextBlock);
+        return;
     }
 
-    return 0;
-}
+    auto block = cursor.block();
 
-bool QCodeEditor::proceedCompleterBegin(QKeyEvent *e)
-{
-    if (m_completer &&
-        m_completer->popup()->isVisible())
+    m_hoverRequest.blockNumber = block.blockNumber();
+    m_hoverRequest.revision = block.revision();
+    m_hoverRequest.key = QString("%1:%2:%3")
+        .arg(m_hoverRequest.blockNumber)
+        .arg(m_hoverRequest.revision)
+        .arg(word);
+    m_hoverRequest.rect = rect;
+    m_hoverRequest.message = message;
+
+    if (auto cached = m_hoverCache.object(m_hoverRequest.key))
     {
-        switch (e->key())
-        {
-        case Qt::Key_Enter:
-        case Qt::Key_Return:
-        case Qt::Key_Escape:
-        case Qt::Key_Tab:
-        case Qt::Key_Backtab:
-            e->ignore();
-            return true; // let the completer do default behavior
-        default:
-            break;
-        }
+        showHover(*cached);
+        return;
     }
 
-    // todo: Replace with modifiable QShortcut
-    auto isShortcut = ((e->modifiers() & Qt::ControlModifier) && e->key() == Qt::Key_Space);
+    if (!message.isEmpty())
+    {
+        showHover(QString());
+    }
 
-    return !(!m_completer || !isShortcut);
+    m_hoverRequest.id = m_hoverRequestCounter++;
 
+    m_hoverProvider->requestHover(
+        m_hoverRequest.id,
+        word,
+        cursor.selectionStart()
+    );
 }
 
-void QCodeEditor::proceedCompleterEnd(QKeyEvent *e)
+void QCodeEditor::onHoverReady(int requestId, QString text)
 {
-    auto ctrlOrShift = e->modifiers() & (Qt::ControlModifier | Qt::ShiftModifier);
-
-    if (!m_completer ||
-        (ctrlOrShift && e->text().isEmpty()) ||
-        e->key() == Qt::Key_Delete)
+    // Answer for cancelled request
+    if (requestId < 0 ||
+        requestId != m_hoverRequest.id)
     {
         return;
     }
 
-    static QString eow(R"(~!@#$%^&*()_+{}|:"<>?,./;'[]\-=)");
+    m_hoverRequest.id = -1;
 
-    auto isShortcut = ((e->modifiers() & Qt::ControlModifier) && e->key() == Qt::Key_Space);
-    auto completionPrefix = wordUnderCursor();
+    // Text was changed after request
+    auto block = document()->findBlockByNumber(m_hoverRequest.blockNumber);
 
-    if (!isShortcut &&
-        (e->text().isEmpty() ||
-         completionPrefix.length() < 2 ||
-         eow.contains(e->text().right(1))))
+    if (!block.isValid() ||
+        block.revision() != m_hoverRequest.revision)
     {
-        m_completer->popup()->hide();
         return;
     }
 
-    if (completionPrefix != m_completer->completionPrefix())
+    m_hoverCache.insert(m_hoverRequest.key, new QString(text));
+
+    showHover(text);
+}
+
+void QCodeEditor::cancelHover()
+{
+    if (m_hoverRequest.id < 0)
     {
-        m_completer->setCompletionPrefix(completionPrefix);
-        m_completer->popup()->setCurrentIndex(m_completer->completionModel()->index(0, 0));
+        return;
     }
 
-    auto cursRect = cursorRect();
-    cursRect.setWidth(
-        m_completer->popup()->sizeHintForColumn(0) +
-        m_completer->popup()->verticalScrollBar()->sizeHint().width()
-    );
+    if (m_hoverProvider)
+    {
+        m_hoverProvider->cancelHover(m_hoverRequest.id);
+    }
 
-    m_completer->complete(cursRect);
+    m_hoverRequest.id = -1;
 }
 
-void QCodeEditor::keyPressEvent(QKeyEvent* e) {
-#if QT_VERSION >= 0x050A00
-  const int defaultIndent = tabStopDistance() / fontMetrics().averageCharWidth();
-#else
-  const int defaultIndent = tabStopWidth() / fontMetrics().averageCharWidth();
-#endif
-
-  auto completerSkip = proceedCompleterBegin(e);
+void QCodeEditor::showHover(const QString& text)
+{
+    auto tooltip = m_hoverRequest.message;
 
-  if (!completerSkip) {
-    if (m_replaceTab && e->key() == Qt::Key_Tab &&
-        e->modifiers() == Qt::NoModifier) {
-      insertPlainText(m_tabReplace);
-      return;
+    if (!tooltip.isEmpty() && !text.isEmpty())
+    {
+        tooltip += "\n\n";
     }
 
-    // Auto indentation
-    int indentationLevel = getIndentationSpaces();
-
-#if QT_VERSION >= 0x050A00
-    int tabCounts =
-        indentationLevel * fontMetrics().averageCharWidth() / tabStopDistance();
-#else
-    int tabCounts =
-        indentationLevel * fontMetrics().averageCharWidth() / tabStopWidth();
-#endif
+    tooltip += text;
 
-    // Have Qt Edior like behaviour, if {|} and enter is pressed indent the two
-    // parenthesis
-    if (m_autoIndentation && 
-       (e->key() == Qt::Key_Return || e->key() == Qt::Key_Enter) &&
-        charUnderCursor() == '}' && charUnderCursor(-1) == '{') 
-    {
-      int charsBack = 0;
-      insertPlainText("\n");
-
-      if (m_replaceTab)
-        insertPlainText(QString(indentationLevel + defaultIndent, ' '));
-      else
-        insertPlainText(QString(tabCounts + 1, '\t'));
-
-      insertPlainText("\n");
-      charsBack++;
-
-      if (m_replaceTab) 
-      {
-        insertPlainText(QString(indentationLevel, ' '));
-        charsBack += indentationLevel;
-      }
-      else 
-      {
-        insertPlainText(QString(tabCounts, '\t'));
-        charsBack += tabCounts;
-      }
-
-      while (charsBack--)
-        moveCursor(QTextCursor::MoveOperation::Left);
-      return;
+    if (tooltip.isEmpty())
+    {
+        return;
     }
 
-    // Shortcut for moving line to left
-    if (m_replaceTab && e->key() == Qt::Key_Backtab) {
-      indentationLevel = std::min(indentationLevel, m_tabReplace.size());
-
-      auto cursor = textCursor();
+    QToolTip::showText(
+        viewport()->mapToGlobal(m_hoverPoint),
+        tooltip,
+        viewport(),
+        m_hoverRequest.rect
+    );
+}
 
-      cursor.movePosition(QTextCursor::MoveOperation::StartOfLine);
-      cursor.movePosition(QTextCursor::MoveOperation::Right,
-                          QTextCursor::MoveMode::KeepAnchor, indentationLevel);
+bool QCodeEditor::proceedAutoParentheses(QKeyEvent* e,
+                                         const QSyntaxBlockData::TokenSpan& token,
+                                         int positionInBlock)
+{
+    QTracer::Span span(m_tracer, "autoParentheses");
 
-      cursor.removeSelectedText();
-      return;
+    if (isReadOnly() ||
+        overwriteMode() ||
+        e->text().isEmpty())
+    {
+        return false;
     }
 
-    QTextEdit::keyPressEvent(e);
-
-    if (m_autoIndentation && (e->key() == Qt::Key_Return || e->key() == Qt::Key_Enter)) {
-      if (m_replaceTab)
-        insertPlainText(QString(indentationLevel, ' '));
-      else
-        insertPlainText(QString(tabCounts, '\t'));
-    }
+    auto cursor = textCursor();
 
-    if (m_autoParentheses) 
+    for (auto&& el : parentheses)
     {
-      for (auto&& el : parentheses) 
-      {
-                // Inserting closed brace
-                if (el.first == e->text()) 
-                {
-                  insertPlainText(el.second);
-                  moveCursor(QTextCursor::MoveOperation::Left);
-                  break;
-                }
+        // Skipping closing quote of string
+        if (el.first == el.second &&
+            el.second == e->text() &&
+            token.type == QSyntaxBlockData::TokenType::String &&
+            token.start + token.length == positionInBlock + 1)
+        {
+            if (!cursor.hasSelection() &&
+                charUnderCursor() == el.second)
+            {
+                moveCursor(QTextCursor::MoveOperation::Right);
+                return true;
+            }
 
-                // If it's close brace - check parentheses
-                if (el.second == e->text())
-                {
-                    auto symbol = charUnderCursor();
+            return false;
+        }
 
-                    if (symbol == el.second)
-                    {
-                        textCursor().deletePreviousChar();
-                        moveCursor(QTextCursor::MoveOperation::Right);
-                    }
+        // Inserting closed brace outside of strings and comments
+        if (el.first == e->text())
+        {
+            if (token.type != QSyntaxBlockData::TokenType::Code)
+            {
+                return false;
+            }
 
-                    break;
-                }
+            cursor.insertText(el.first + el.second);
+            cursor.movePosition(
+                QTextCursor::MoveOperation::Left,
+                QTextCursor::MoveMode::MoveAnchor,
+                el.second.size()
+            );
+
+            setTextCursor(cursor);
+            return true;
+        }
+
+        // If it's close brace - check parentheses
+        if (el.second == e->text())
+        {
+            if (!cursor.hasSelection() &&
+                charUnderCursor() == el.second)
+            {
+                moveCursor(QTextCursor::MoveOperation::Right);
+                return true;
             }
+
+            return false;
         }
     }
 
-    proceedCompleterEnd(e);
+    return false;
 }
 
-void QCodeEditor::setAutoIndentation(bool enabled)
+QStringList QCodeEditor::blocksText(const QTextBlock& first, const QTextBlock& last) const
 {
-    m_autoIndentation = enabled;
-}
+    QStringList lines;
 
-bool QCodeEditor::autoIndentation() const
-{
-    return m_autoIndentation;
-}
+    for (auto block = first; block.isValid(); block = block.next())
+    {
+        lines.append(block.text());
 
-void QCodeEditor::setAutoParentheses(bool enabled)
-{
-    m_autoParentheses = enabled;
-}
+        if (block == last)
+        {
+            break;
+        }
+    }
 
-bool QCodeEditor::autoParentheses() const
-{
-    return m_autoParentheses;
+    return lines;
 }
 
-void QCodeEditor::setTabReplace(bool enabled)
+void QCodeEditor::replaceBlocks(const QTextBlock& first,
+                                const QTextBlock& last,
+                                const QString& text,
+                                int anchor,
+                                int position)
 {
-    m_replaceTab = enabled;
-}
+    QTextCursor cursor(document());
+    cursor.setPosition(first.position());
+    cursor.setPosition(
+        last.position() + last.length() - 1,
+        QTextCursor::MoveMode::KeepAnchor
+    );
 
-bool QCodeEditor::tabReplace() const
-{
-    return m_replaceTab;
-}
+    // Big documents are highlighted in background
+    auto deferred = m_highlighter && text.size() >= m_largePasteSize;
 
-void QCodeEditor::setTabReplaceSize(int val)
-{
-    m_tabReplace.clear();
+    if (deferred)
+    {
+        m_highlighter->setHighlightingDeferred(true);
+    }
 
-    m_tabReplace.fill(' ', val);
-}
+    if (text.isEmpty())
+    {
+        cursor.removeSelectedText();
+    }
+    else
+    {
+        cursor.insertText(text);
+    }
 
-int QCodeEditor::tabReplaceSize() const
-{
-    return m_tabReplace.size();
+    if (deferred)
+    {
+        m_highlighter->setHighlightingDeferred(false);
+        m_highlightTimer->start(0);
+    }
+
+    auto lastPosition = document()->characterCount() - 1;
+
+    cursor.setPosition(qBound(0, anchor, lastPosition));
+    cursor.setPosition(qBound(0, position, lastPosition), QTextCursor::MoveMode::KeepAnchor);
+
+    setTextCursor(cursor);
 }
 
-void QCodeEditor::setCompleter(QCompleter *completer)
+QPair<QTextBlock, QTextBlock> QCodeEditor::selectedBlocks(const QTextCursor& cursor) const
 {
-    if (m_completer)
+    auto first = document()->findBlock(cursor.selectionStart());
+    auto last = document()->findBlock(cursor.selectionEnd());
+
+    if (last.blockNumber() > first.blockNumber() &&
+        last.position() == cursor.selectionEnd())
     {
-        disconnect(m_completer, nullptr, this, nullptr);
+        last = last.previous();
     }
 
-    m_completer = completer;
+    return {first, last};
+}
 
-    if (!m_completer)
+void QCodeEditor::selectBlocks(const QTextBlock& first, const QTextBlock& last)
+{
+    auto cursor = textCursor();
+    auto start = first.position();
+    auto end = last.position() + last.length() - 1;
+
+    if (cursor.position() < cursor.anchor())
     {
-        return;
+        std::swap(start, end);
     }
 
-    m_completer->setWidget(this);
-    m_completer->setCompletionMode(QCompleter::CompletionMode::PopupCompletion);
+    cursor.setPosition(start);
+    cursor.setPosition(end, QTextCursor::MoveMode::KeepAnchor);
 
-    connect(
-        m_completer,
-        QOverload<const QString&>::of(&QCompleter::activated),
-        this,
-        &QCodeEditor::insertCompletion
-    );
+    setTextCursor(cursor);
 }
 
-void QCodeEditor::focusInEvent(QFocusEvent *e)
+QChar QCodeEditor::charUnderCursor(int offset) const
 {
-    if (m_completer)
+    auto cursor = textCursor();
+    auto block = cursor.block();
+    auto index = cursor.positionInBlock() + offset;
+
+    // Block text isn't copied, length includes separator
+    if (index < 0 || index >= block.length() - 1)
     {
-        m_completer->setWidget(this);
+        return {};
     }
 
-    QTextEdit::focusInEvent(e);
+    return document()->characterAt(block.position() + index);
 }
 
-void QCodeEditor::insertCompletion(QString s)
+QSyntaxBlockData::TokenSpan QCodeEditor::tokenSpanUnderCursor() const
 {
-    if (m_completer->widget() != this)
+    auto cursor = textCursor();
+    auto position = cursor.positionInBlock();
+    auto block = cursor.block();
+
+    QSyntaxBlockData::TokenSpan code{position, 0, QSyntaxBlockData::TokenType::Code};
+
+    auto data = dynamic_cast<QSyntaxBlockData*>(block.userData());
+
+    if (m_highlighter == nullptr ||
+        data == nullptr ||
+        data->index() != m_highlighter->bracketIndex() ||
+        position == 0)
     {
-        return;
+        return code;
     }
 
-    auto tc = textCursor();
-    tc.select(QTextCursor::SelectionType::WordUnderCursor);
-    tc.insertText(s);
-    setTextCursor(tc);
-}
+    // Token has to contain character before cursor
+    auto span = data->tokenSpanAt(position - 1);
 
-QCompleter *QCodeEditor::completer() const
-{
-    return m_completer;
-}
+    if (span == nullptr)
+    {
+        return code;
+    }
 
-QChar QCodeEditor::charUnderCursor(int offset) const
-{
-    auto block = textCursor().blockNumber();
-    auto index = textCursor().positionInBlock();
-    auto text = document()->findBlockByNumber(block).text();
+    auto end = span->start + span->length;
 
-    index += offset;
+    if (end > position)
+    {
+        return *span;
+    }
 
-    if (index < 0 || index >= text.size())
+    // Cursor is right after token. It's still inside,
+    // if token continues on next line or string isn't closed
+    if (end < block.length() - 1)
     {
-        return {};
+        return code;
+    }
+
+    if (span->type == QSyntaxBlockData::TokenType::Comment)
+    {
+        return *span;
+    }
+
+    auto quote = document()->characterAt(block.position() + span->start);
+    auto last = document()->characterAt(block.position() + end - 1);
+
+    if (span->length > 1 && last == quote)
+    {
+        return code;
     }
 
-    return text[index];
+    return *span;
 }
 
 QString QCodeEditor::wordUnderCursor() const
@@ -710,30 +3497,106 @@ QString QCodeEditor::wordUnderCursor() const
 
 void QCodeEditor::insertFromMimeData(const QMimeData* source)
 {
-    insertPlainText(source->text());
+    auto text = source->text();
+
+    if (hasBoxSelection())
+    {
+        auto lines = text.split('\n');
+        auto count = std::abs(m_boxSelection.block - m_boxSelection.anchorBlock) + 1;
+
+        // Line per selected line or one line for all of them
+        if (lines.size() == count || lines.size() == 1)
+        {
+            replaceBoxText(
+                std::min(m_boxSelection.anchorColumn, m_boxSelection.column),
+                std::max(m_boxSelection.anchorColumn, m_boxSelection.column),
+                lines
+            );
+            return;
+        }
+
+        clearBoxSelection();
+    }
+
+    if (hasActiveSnippet())
+    {
+        // Snippet mirrors are updated in the same undo step
+        auto cursor = textCursor();
+
+        cursor.beginEditBlock();
+        insertPlainText(text);
+        updateSnippetMirrors();
+        cursor.endEditBlock();
+        return;
+    }
+
+    if (text.size() < m_largePasteSize)
+    {
+        insertPlainText(text);
+        return;
+    }
+
+    QTracer::Span span(m_tracer, "largePaste");
+
+    // CR would be inserted as separate block
+    normalizeLineEndings(text);
+
+    if (m_highlighter == nullptr)
+    {
+        insertPlainText(text);
+        return;
+    }
+
+    // Inserted blocks are highlighted after viewport is shown
+    m_highlighter->setHighlightingDeferred(true);
+    insertPlainText(text);
+    m_highlighter->setHighlightingDeferred(false);
+
+    m_highlightTimer->start(0);
+}
+
+void QCodeEditor::highlightPendingBlocks()
+{
+    QTracer::Span span(m_tracer, "highlightPendingBlocks");
+
+    // Time limit keeps editor responsive
+    if (m_highlighter &&
+        m_highlighter->highlightPendingBlocks(10))
+    {
+        m_highlightTimer->start(0);
+    }
 }
 
 int QCodeEditor::getIndentationSpaces()
 {
-    auto blockText = textCursor().block().text();
+    auto block = textCursor().block();
+
+#if QT_VERSION >= 0x050A00
+    auto tabSpaces = tabStopDistance() / fontMetrics().averageCharWidth();
+#else
+    auto tabSpaces = tabStopWidth() / fontMetrics().averageCharWidth();
+#endif
 
     int indentationLevel = 0;
 
-    for (auto i = 0;
-         i < blockText.size() && QString("\t ").contains(blockText[i]);
-         ++i)
+    // Only indentation is read, block text isn't copied
+    for (auto position = block.position();
+         position < block.position() + block.length() - 1;
+         ++position)
     {
-        if (blockText[i] == ' ')
+        auto character = document()->characterAt(position);
+
+        if (character == ' ')
         {
             indentationLevel++;
         }
+        else if (character == '\t')
+        {
+            indentationLevel += tabSpaces;
+        }
         else
         {
-#if QT_VERSION >= 0x050A00
-            indentationLevel += tabStopDistance() / fontMetrics().averageCharWidth();
-#else
-            indentationLevel += tabStopWidth() / fontMetrics().averageCharWidth();
-#endif
+            break;
         }
     }
 
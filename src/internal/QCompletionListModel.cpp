@@ -0,0 +1,222 @@
+// QCodeEditor
+#include <QCompletionListModel>
+#include <QFuzzyMatcher>
+
+// C++ STL
+#include <algorithm>
+#include <numeric>
+
+QCompletionListModel::QCompletionListModel(const QStringList& words, QObject* parent) :
+    QAbstractListModel(parent),
+    m_keys(),
+    m_words(),
+    m_masks(),
+    m_maximumRows(1000),
+    m_fuzzyMatching(false),
+    m_prefix(),
+    m_documentWords(),
+    m_first(0),
+    m_last(0),
+    m_matches()
+{
+    setWords(words);
+}
+
+void QCompletionListModel::setWords(const QStringList& words)
+{
+    beginResetModel();
+
+    QVector<QString> keys;
+    keys.reserve(words.size());
+
+    for (auto& word : words)
+    {
+        keys.append(word.toLower());
+    }
+
+    // Words are sorted by index, so they aren't moved twice
+    QVector<int> order(words.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::sort(
+        order.begin(),
+        order.end(),
+        [&keys, &words](int a, int b)
+        {
+            return keys[a] != keys[b] ? keys[a] < keys[b] : words[a] < words[b];
+        }
+    );
+
+    m_keys.clear();
+    m_words.clear();
+    m_masks.clear();
+    m_keys.reserve(order.size());
+    m_words.reserve(order.size());
+    m_masks.reserve(order.size());
+
+    for (auto index : order)
+    {
+        if (!m_words.isEmpty() && m_words.last() == words[index])
+        {
+            continue;
+        }
+
+        m_keys.append(keys[index]);
+        m_words.append(words[index]);
+        m_masks.append(QFuzzyMatcher::characterMask(words[index]));
+    }
+
+    m_prefix.clear();
+    m_documentWords.clear();
+    m_first = 0;
+    m_last = m_words.size();
+    m_matches.clear();
+
+    endResetModel();
+}
+
+QStringList QCompletionListModel::words() const
+{
+    return QStringList(QList<QString>::fromVector(m_words));
+}
+
+void QCompletionListModel::setMaximumRows(int rows)
+{
+    beginResetModel();
+    m_maximumRows = std::max(0, rows);
+    endResetModel();
+}
+
+int QCompletionListModel::maximumRows() const
+{
+    return m_maximumRows;
+}
+
+void QCompletionListModel::setFuzzyMatching(bool enabled)
+{
+    m_fuzzyMatching = enabled;
+
+    // Members are reset by filtering
+    auto prefix = m_prefix;
+    auto documentWords = m_documentWords;
+
+    setCompletionPrefix(prefix, documentWords);
+}
+
+bool QCompletionListModel::fuzzyMatching() const
+{
+    return m_fuzzyMatching;
+}
+
+void QCompletionListModel::setCompletionPrefix(const QString& prefix,
+                                               const QStringList& documentWords)
+{
+    beginResetModel();
+
+    auto key = prefix.toLower();
+    auto size = key.size();
+
+    // Keys with prefix are contiguous in sorted keys
+    auto first = std::lower_bound(
+        m_keys.begin(),
+        m_keys.end(),
+        key,
+        [size](const QString& a, const QString& b)
+        {
+            return a.leftRef(size).compare(b) < 0;
+        }
+    );
+
+    auto last = std::upper_bound(
+        first,
+        m_keys.end(),
+        key,
+        [size](const QString& a, const QString& b)
+        {
+            return a.compare(b.leftRef(size)) < 0;
+        }
+    );
+
+    m_prefix = prefix;
+    m_first = static_cast<int>(first - m_keys.begin());
+    m_last = static_cast<int>(last - m_keys.begin());
+    m_matches.clear();
+
+    if (m_fuzzyMatching && !prefix.isEmpty())
+    {
+        m_matches = QFuzzyMatcher(prefix).match(m_words, m_masks, m_maximumRows);
+    }
+
+    m_documentWords.clear();
+
+    for (auto& word : documentWords)
+    {
+        if (!containsWord(word))
+        {
+            m_documentWords.append(word);
+        }
+    }
+
+    endResetModel();
+}
+
+QString QCompletionListModel::completionPrefix() const
+{
+    return m_prefix;
+}
+
+int QCompletionListModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+
+    auto rows = m_documentWords.size() +
+                (isFuzzy() ? m_matches.size() : m_last - m_first);
+
+    return m_maximumRows > 0 ? std::min(rows, m_maximumRows) : rows;
+}
+
+QVariant QCompletionListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() ||
+        index.row() >= rowCount() ||
+        (role != Qt::DisplayRole && role != Qt::EditRole))
+    {
+        return QVariant();
+    }
+
+    auto row = index.row();
+
+    if (row < m_documentWords.size())
+    {
+        return m_documentWords[row];
+    }
+
+    row -= m_documentWords.size();
+
+    return m_words[isFuzzy() ? m_matches[row] : m_first + row];
+}
+
+bool QCompletionListModel::isFuzzy() const
+{
+    return m_fuzzyMatching && !m_prefix.isEmpty();
+}
+
+bool QCompletionListModel::containsWord(const QString& word) const
+{
+    auto key = word.toLower();
+    auto it = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+
+    // Words with the same key are neighbours
+    for (; it != m_keys.end() && *it == key; ++it)
+    {
+        if (m_words[static_cast<int>(it - m_keys.begin())] == word)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
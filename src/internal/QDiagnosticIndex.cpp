@@ -0,0 +1,319 @@
+// QCodeEditor
+#include <QDiagnosticIndex>
+
+// C++ STL
+#include <algorithm>
+#include <limits>
+
+struct QDiagnosticIndex::Node
+{
+    explicit Node(QDiagnostic d, quint32 p) :
+        diagnostic(std::move(d)),
+        priority(p),
+        maxEnd(diagnostic.end),
+        pending(0),
+        left(nullptr),
+        right(nullptr)
+    {}
+
+    QDiagnostic diagnostic;
+    quint32 priority;
+    int maxEnd;
+    int pending;
+    Node* left;
+    Node* right;
+};
+
+QDiagnosticIndex::QDiagnosticIndex() :
+    m_root(nullptr),
+    m_size(0),
+    m_seed(2463534242u)
+{
+
+}
+
+QDiagnosticIndex::~QDiagnosticIndex()
+{
+    destroy(m_root);
+}
+
+void QDiagnosticIndex::setDiagnostics(QVector<QDiagnostic> diagnostics)
+{
+    clear();
+
+    std::stable_sort(
+        diagnostics.begin(),
+        diagnostics.end(),
+        [](const QDiagnostic& a, const QDiagnostic& b)
+        {
+            return a.start < b.start;
+        }
+    );
+
+    for (auto& diagnostic : diagnostics)
+    {
+        diagnostic.end = std::max(diagnostic.start, diagnostic.end);
+
+        // Appending to the right end
+        m_root = merge(m_root, new Node(std::move(diagnostic), nextPriority()));
+    }
+
+    m_size = diagnostics.size();
+}
+
+void QDiagnosticIndex::clear()
+{
+    destroy(m_root);
+
+    m_root = nullptr;
+    m_size = 0;
+}
+
+int QDiagnosticIndex::size() const
+{
+    return m_size;
+}
+
+void QDiagnosticIndex::shift(int position, int charsRemoved, int charsAdded)
+{
+    if (m_root == nullptr)
+    {
+        return;
+    }
+
+    auto removedEnd = position + charsRemoved;
+    auto delta = charsAdded - charsRemoved;
+
+    Node* left = nullptr;
+    Node* middle = nullptr;
+    Node* right = nullptr;
+    Node* rest = nullptr;
+
+    split(m_root, position, left, rest);
+    split(rest, removedEnd, middle, right);
+
+    apply(right, delta);
+    collapse(middle, position, removedEnd, delta);
+    adjustEnds(left, position, removedEnd, delta);
+
+    m_root = merge(merge(left, middle), right);
+}
+
+QVector<QDiagnostic> QDiagnosticIndex::diagnostics(int start, int end) const
+{
+    QVector<QDiagnostic> result;
+
+    collect(m_root, 0, start, end, result);
+
+    return result;
+}
+
+QVector<QDiagnostic> QDiagnosticIndex::diagnostics() const
+{
+    QVector<QDiagnostic> result;
+    result.reserve(m_size);
+
+    collect(
+        m_root,
+        0,
+        std::numeric_limits<int>::min(),
+        std::numeric_limits<int>::max(),
+        result
+    );
+
+    return result;
+}
+
+void QDiagnosticIndex::apply(Node* node, int delta)
+{
+    if (node == nullptr || delta == 0)
+    {
+        return;
+    }
+
+    node->diagnostic.start += delta;
+    node->diagnostic.end += delta;
+    node->maxEnd += delta;
+    node->pending += delta;
+}
+
+void QDiagnosticIndex::push(Node* node)
+{
+    if (node->pending != 0)
+    {
+        apply(node->left, node->pending);
+        apply(node->right, node->pending);
+
+        node->pending = 0;
+    }
+}
+
+void QDiagnosticIndex::pull(Node* node)
+{
+    node->maxEnd = node->diagnostic.end;
+
+    if (node->left)
+    {
+        node->maxEnd = std::max(node->maxEnd, node->left->maxEnd);
+    }
+
+    if (node->right)
+    {
+        node->maxEnd = std::max(node->maxEnd, node->right->maxEnd);
+    }
+}
+
+void QDiagnosticIndex::split(Node* node, int position, Node*& left, Node*& right)
+{
+    if (node == nullptr)
+    {
+        left = nullptr;
+        right = nullptr;
+        return;
+    }
+
+    push(node);
+
+    if (node->diagnostic.start < position)
+    {
+        split(node->right, position, node->right, right);
+        left = node;
+    }
+    else
+    {
+        split(node->left, position, left, node->left);
+        right = node;
+    }
+
+    pull(node);
+}
+
+QDiagnosticIndex::Node* QDiagnosticIndex::merge(Node* left, Node* right)
+{
+    if (left == nullptr)
+    {
+        return right;
+    }
+
+    if (right == nullptr)
+    {
+        return left;
+    }
+
+    if (left->priority > right->priority)
+    {
+        push(left);
+        left->right = merge(left->right, right);
+        pull(left);
+
+        return left;
+    }
+
+    push(right);
+    right->left = merge(left, right->left);
+    pull(right);
+
+    return right;
+}
+
+void QDiagnosticIndex::collapse(Node* node, int position, int removedEnd, int delta)
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    push(node);
+
+    collapse(node->left, position, removedEnd, delta);
+    collapse(node->right, position, removedEnd, delta);
+
+    auto& diagnostic = node->diagnostic;
+
+    diagnostic.start = position;
+    diagnostic.end = diagnostic.end >= removedEnd ?
+        diagnostic.end + delta :
+        position;
+
+    pull(node);
+}
+
+void QDiagnosticIndex::adjustEnds(Node* node, int position, int removedEnd, int delta)
+{
+    // Only nodes, that end after edit position
+    if (node == nullptr || node->maxEnd <= position)
+    {
+        return;
+    }
+
+    push(node);
+
+    adjustEnds(node->left, position, removedEnd, delta);
+    adjustEnds(node->right, position, removedEnd, delta);
+
+    auto& diagnostic = node->diagnostic;
+
+    if (diagnostic.end > position)
+    {
+        diagnostic.end = diagnostic.end >= removedEnd ?
+            diagnostic.end + delta :
+            position;
+    }
+
+    pull(node);
+}
+
+void QDiagnosticIndex::collect(const Node* node,
+                               int offset,
+                               int start,
+                               int end,
+                               QVector<QDiagnostic>& result)
+{
+    if (node == nullptr || node->maxEnd + offset < start)
+    {
+        return;
+    }
+
+    collect(node->left, offset + node->pending, start, end, result);
+
+    // Right subtree starts after node
+    if (node->diagnostic.start + offset > end)
+    {
+        return;
+    }
+
+    if (node->diagnostic.end + offset >= start)
+    {
+        auto diagnostic = node->diagnostic;
+
+        diagnostic.start += offset;
+        diagnostic.end += offset;
+
+        result.append(std::move(diagnostic));
+    }
+
+    collect(node->right, offset + node->pending, start, end, result);
+}
+
+void QDiagnosticIndex::destroy(Node* node)
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    destroy(node->left);
+    destroy(node->right);
+
+    delete node;
+}
+
+quint32 QDiagnosticIndex::nextPriority()
+{
+    // xorshift32
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    return m_seed;
+}
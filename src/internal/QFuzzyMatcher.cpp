@@ -0,0 +1,274 @@
+// QCodeEditor
+#include <QFuzzyMatcher>
+
+// Qt
+#include <QtAlgorithms>
+
+// C++ STL
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Smaller parts aren't worth a thread
+    const int minimumPart = 1 << 15;
+
+    // Longer words aren't identifiers and aren't scored
+    const int maximumWordLength = 256;
+
+    // Score of position, where pattern can't be matched
+    const int unmatched = -(1 << 24);
+
+    int boundaryBonus(const QChar* word, int position)
+    {
+        if (position == 0)
+        {
+            return 8;
+        }
+
+        auto previous = word[position - 1];
+        auto current = word[position];
+
+        if (!previous.isLetterOrNumber() && current.isLetterOrNumber())
+        {
+            return 6;
+        }
+
+        // Camel case hump
+        if (previous.isLower() && current.isUpper())
+        {
+            return 6;
+        }
+
+        return 0;
+    }
+}
+
+QFuzzyMatcher::QFuzzyMatcher(const QString& pattern) :
+    m_pattern(pattern),
+    m_lowerPattern(pattern.toLower()),
+    m_mask(characterMask(pattern))
+{
+
+}
+
+quint64 QFuzzyMatcher::mask() const
+{
+    return m_mask;
+}
+
+int QFuzzyMatcher::score(const QString& word) const
+{
+    auto size = word.size();
+    auto patternSize = m_pattern.size();
+
+    if (patternSize == 0)
+    {
+        return 0;
+    }
+
+    if (patternSize > size || size > maximumWordLength)
+    {
+        return -1;
+    }
+
+    auto data = word.constData();
+    auto pattern = m_pattern.constData();
+    auto lowerPattern = m_lowerPattern.constData();
+
+    // Best score with previous pattern character at position
+    int previous[maximumWordLength];
+    int current[maximumWordLength];
+
+    for (auto i = 0; i < patternSize; ++i)
+    {
+        // Best score of previous character before position - 1
+        auto best = unmatched;
+
+        for (auto j = 0; j < size; ++j)
+        {
+            current[j] = unmatched;
+
+            if (i > 0 && j > 1)
+            {
+                best = std::max(best, previous[j - 2]);
+            }
+
+            if (data[j].toLower() != lowerPattern[i])
+            {
+                continue;
+            }
+
+            auto value = 1 + boundaryBonus(data, j) + (data[j] == pattern[i] ? 1 : 0);
+
+            if (i == 0)
+            {
+                current[j] = value;
+                continue;
+            }
+
+            // Consecutive match or match after gap
+            auto consecutive = j > 0 && previous[j - 1] > unmatched ? previous[j - 1] + 6 : unmatched;
+            auto gap = best > unmatched ? best - 3 : unmatched;
+            auto before = std::max(consecutive, gap);
+
+            if (before > unmatched)
+            {
+                current[j] = before + value;
+            }
+        }
+
+        std::copy(current, current + size, previous);
+    }
+
+    auto result = *std::max_element(previous, previous + size);
+
+    if (result <= unmatched)
+    {
+        return -1;
+    }
+
+    // Shorter words are closer to pattern
+    return std::max(0, result * 8 - (size - patternSize));
+}
+
+QVector<int> QFuzzyMatcher::match(const QVector<QString>& words,
+                                  const QVector<quint64>& masks,
+                                  int limit) const
+{
+    auto threads = std::min(
+        static_cast<int>(std::max(1u, std::thread::hardware_concurrency())),
+        words.size() / minimumPart
+    );
+
+    QVector<Match> matches;
+
+    if (threads < 2)
+    {
+        matchRange(words, masks, 0, words.size(), matches);
+    }
+    else
+    {
+        std::vector<QVector<Match>> parts(threads);
+        std::vector<std::thread> workers;
+
+        auto partSize = (words.size() + threads - 1) / threads;
+
+        for (auto i = 0; i < threads; ++i)
+        {
+            workers.emplace_back(
+                &QFuzzyMatcher::matchRange,
+                this,
+                std::cref(words),
+                std::cref(masks),
+                i * partSize,
+                std::min(words.size(), (i + 1) * partSize),
+                std::ref(parts[i])
+            );
+        }
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        // Parts are joined in index order
+        for (auto& part : parts)
+        {
+            matches += part;
+        }
+    }
+
+    auto count = limit > 0 ? std::min(limit, matches.size()) : matches.size();
+
+    std::partial_sort(
+        matches.begin(),
+        matches.begin() + count,
+        matches.end(),
+        [](const Match& a, const Match& b)
+        {
+            return a.score != b.score ? a.score > b.score : a.index < b.index;
+        }
+    );
+
+    QVector<int> indexes;
+    indexes.reserve(count);
+
+    for (auto i = 0; i < count; ++i)
+    {
+        indexes.append(matches[i].index);
+    }
+
+    return indexes;
+}
+
+void QFuzzyMatcher::matchRange(const QVector<QString>& words,
+                               const QVector<quint64>& masks,
+                               int first,
+                               int last,
+                               QVector<Match>& matches) const
+{
+    auto mask = m_mask;
+    auto wordMasks = masks.constData();
+
+    for (auto block = first; block < last; block += 64)
+    {
+        auto end = std::min(last, block + 64);
+        quint64 passed = 0;
+
+        // Branchless check is vectorized by compilers, words
+        // without all pattern characters aren't scored
+        for (auto i = block; i < end; ++i)
+        {
+            passed |= quint64((wordMasks[i] & mask) == mask) << (i - block);
+        }
+
+        while (passed != 0)
+        {
+            auto index = block + static_cast<int>(qCountTrailingZeroBits(passed));
+            passed &= passed - 1;
+
+            auto value = score(words[index]);
+
+            if (value >= 0)
+            {
+                matches.append({value, index});
+            }
+        }
+    }
+}
+
+quint64 QFuzzyMatcher::characterMask(const QString& text)
+{
+    quint64 mask = 0;
+
+    for (auto c : text)
+    {
+        auto unicode = c.toLower().unicode();
+        int bit;
+
+        if (unicode >= 'a' && unicode <= 'z')
+        {
+            bit = unicode - 'a';
+        }
+        else if (unicode >= '0' && unicode <= '9')
+        {
+            bit = 26 + unicode - '0';
+        }
+        else if (unicode == '_')
+        {
+            bit = 36;
+        }
+        else
+        {
+            // Other characters share bits
+            bit = 37 + unicode % 27;
+        }
+
+        mask |= quint64(1) << bit;
+    }
+
+    return mask;
+}
@@ -1,9 +1,9 @@
 // QCodeEditor
 #include <QGLSLCompleter>
 #include <QLanguage>
+#include <QCompletionListModel>
 
 // Qt
-#include <QStringListModel>
 #include <QFile>
 
 QGLSLCompleter::QGLSLCompleter(QObject *parent) :
@@ -34,9 +34,10 @@ QGLSLCompleter::QGLSLCompleter(QObject *parent) :
         list.append(names);
     }
 
-    setModel(new QStringListModel(list, this));
+    // Model filters rows by itself
+    setModel(new QCompletionListModel(list, this));
     setCompletionColumn(0);
-    setModelSorting(QCompleter::CaseInsensitivelySortedModel);
+    setCompletionMode(QCompleter::UnfilteredPopupCompletion);
     setCaseSensitivity(Qt::CaseSensitive);
     setWrapAround(true);
 }
@@ -31,6 +31,8 @@ QGLSLHighlighter::QGLSLHighlighter(QTextDocument* document) :
         return;
     }
 
+    setCommentTokens(language.lineComment(), language.blockComment());
+
     auto keys = language.keys();
     for (auto&& key : keys)
     {
@@ -66,7 +68,7 @@ QGLSLHighlighter::QGLSLHighlighter(QTextDocument* document) :
     });
 }
 
-void QGLSLHighlighter::highlightBlock(const QString& text)
+void QGLSLHighlighter::highlightSyntax(const QString& text)
 {
 
     {
@@ -76,16 +78,16 @@ void QGLSLHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Preprocessor")
+                "Preprocessor"
             );
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(1),
                 match.capturedLength(1),
-                syntaxStyle()->getFormat("String")
+                "String"
             );
         }
     }
@@ -97,16 +99,16 @@ void QGLSLHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Type")
+                "Type"
             );
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(2),
                 match.capturedLength(2),
-                syntaxStyle()->getFormat("Function")
+                "Function"
             );
         }
     }
@@ -119,10 +121,10 @@ void QGLSLHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat(rule.formatName)
+                rule.formatName
             );
         }
     }
@@ -152,10 +154,10 @@ void QGLSLHighlighter::highlightBlock(const QString& text)
             commentLength = endIndex - startIndex + match.capturedLength();
         }
 
-        setFormat(
+        setStyleFormat(
             startIndex,
             commentLength,
-            syntaxStyle()->getFormat("Comment")
+            "Comment"
         );
         startIndex = text.indexOf(m_commentStartPattern, startIndex + commentLength);
     }
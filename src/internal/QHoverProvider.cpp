@@ -0,0 +1,13 @@
+// QCodeEditor
+#include <QHoverProvider>
+
+QHoverProvider::QHoverProvider(QObject* parent) :
+    QObject(parent)
+{
+
+}
+
+void QHoverProvider::cancelHover(int)
+{
+
+}
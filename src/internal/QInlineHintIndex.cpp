@@ -0,0 +1,293 @@
+// QCodeEditor
+#include <QInlineHintIndex>
+
+// Qt
+#include <QFontMetrics>
+
+// C++ STL
+#include <algorithm>
+#include <limits>
+
+struct QInlineHintIndex::Node
+{
+    explicit Node(Entry e, quint32 p) :
+        entry(std::move(e)),
+        priority(p),
+        pending(0),
+        left(nullptr),
+        right(nullptr)
+    {}
+
+    Entry entry;
+    quint32 priority;
+    int pending;
+    Node* left;
+    Node* right;
+};
+
+QInlineHintIndex::QInlineHintIndex() :
+    m_root(nullptr),
+    m_size(0),
+    m_seed(2463534242u)
+{
+
+}
+
+QInlineHintIndex::~QInlineHintIndex()
+{
+    destroy(m_root);
+}
+
+void QInlineHintIndex::setHints(QVector<QInlineHint> hints, const QFontMetrics& metrics)
+{
+    clear();
+
+    std::stable_sort(
+        hints.begin(),
+        hints.end(),
+        [](const QInlineHint& a, const QInlineHint& b)
+        {
+            return a.position < b.position;
+        }
+    );
+
+    QVector<Entry> entries;
+
+    for (auto& hint : hints)
+    {
+        if (!entries.empty() &&
+            entries.last().hint.position == hint.position)
+        {
+            entries.last().hint.text += ' ' + hint.text;
+        }
+        else
+        {
+            entries.append({std::move(hint), 0});
+        }
+    }
+
+    for (auto& entry : entries)
+    {
+#if QT_VERSION >= 0x050B00
+        entry.width = metrics.horizontalAdvance(entry.hint.text);
+#else
+        entry.width = metrics.width(entry.hint.text);
+#endif
+        // Half of character padding on both sides
+        entry.width += metrics.averageCharWidth();
+
+        // Appending to the right end
+        m_root = merge(m_root, new Node(std::move(entry), nextPriority()));
+    }
+
+    m_size = entries.size();
+}
+
+void QInlineHintIndex::clear()
+{
+    destroy(m_root);
+
+    m_root = nullptr;
+    m_size = 0;
+}
+
+int QInlineHintIndex::size() const
+{
+    return m_size;
+}
+
+void QInlineHintIndex::shift(int position, int charsRemoved, int charsAdded)
+{
+    if (m_root == nullptr)
+    {
+        return;
+    }
+
+    Node* left = nullptr;
+    Node* removed = nullptr;
+    Node* right = nullptr;
+    Node* rest = nullptr;
+
+    // Hint at edit position is kept
+    split(m_root, position + 1, left, rest);
+    split(rest, position + charsRemoved + 1, removed, right);
+
+    m_size -= count(removed);
+    destroy(removed);
+
+    apply(right, charsAdded - charsRemoved);
+
+    m_root = merge(left, right);
+}
+
+QVector<QInlineHintIndex::Entry> QInlineHintIndex::hints(int start, int end) const
+{
+    QVector<Entry> result;
+
+    collect(m_root, 0, start, end, result);
+
+    return result;
+}
+
+QVector<QInlineHint> QInlineHintIndex::hints() const
+{
+    QVector<Entry> entries;
+    entries.reserve(m_size);
+
+    collect(
+        m_root,
+        0,
+        std::numeric_limits<int>::min(),
+        std::numeric_limits<int>::max(),
+        entries
+    );
+
+    QVector<QInlineHint> result;
+    result.reserve(entries.size());
+
+    for (auto& entry : entries)
+    {
+        result.append(std::move(entry.hint));
+    }
+
+    return result;
+}
+
+void QInlineHintIndex::apply(Node* node, int delta)
+{
+    if (node == nullptr || delta == 0)
+    {
+        return;
+    }
+
+    node->entry.hint.position += delta;
+    node->pending += delta;
+}
+
+void QInlineHintIndex::push(Node* node)
+{
+    if (node->pending != 0)
+    {
+        apply(node->left, node->pending);
+        apply(node->right, node->pending);
+
+        node->pending = 0;
+    }
+}
+
+void QInlineHintIndex::split(Node* node, int position, Node*& left, Node*& right)
+{
+    if (node == nullptr)
+    {
+        left = nullptr;
+        right = nullptr;
+        return;
+    }
+
+    push(node);
+
+    if (node->entry.hint.position < position)
+    {
+        split(node->right, position, node->right, right);
+        left = node;
+    }
+    else
+    {
+        split(node->left, position, left, node->left);
+        right = node;
+    }
+}
+
+QInlineHintIndex::Node* QInlineHintIndex::merge(Node* left, Node* right)
+{
+    if (left == nullptr)
+    {
+        return right;
+    }
+
+    if (right == nullptr)
+    {
+        return left;
+    }
+
+    if (left->priority > right->priority)
+    {
+        push(left);
+        left->right = merge(left->right, right);
+
+        return left;
+    }
+
+    push(right);
+    right->left = merge(left, right->left);
+
+    return right;
+}
+
+void QInlineHintIndex::collect(const Node* node,
+                               int offset,
+                               int start,
+                               int end,
+                               QVector<Entry>& result)
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    auto position = node->entry.hint.position + offset;
+
+    // Left subtree is before node
+    if (position >= start)
+    {
+        collect(node->left, offset + node->pending, start, end, result);
+    }
+
+    if (position > end)
+    {
+        return;
+    }
+
+    if (position >= start)
+    {
+        auto entry = node->entry;
+        entry.hint.position = position;
+
+        result.append(std::move(entry));
+    }
+
+    collect(node->right, offset + node->pending, start, end, result);
+}
+
+int QInlineHintIndex::count(const Node* node)
+{
+    if (node == nullptr)
+    {
+        return 0;
+    }
+
+    return 1 + count(node->left) + count(node->right);
+}
+
+void QInlineHintIndex::destroy(Node* node)
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    destroy(node->left);
+    destroy(node->right);
+
+    delete node;
+}
+
+quint32 QInlineHintIndex::nextPriority()
+{
+    // xorshift32
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    return m_seed;
+}
@@ -32,7 +32,7 @@ QJSONHighlighter::QJSONHighlighter(QTextDocument* document) :
     });
 }
 
-void QJSONHighlighter::highlightBlock(const QString& text)
+void QJSONHighlighter::highlightSyntax(const QString& text)
 {
     for (auto&& rule : m_highlightRules)
     {
@@ -42,10 +42,10 @@ void QJSONHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat(rule.formatName)
+                rule.formatName
             );
         }
     }
@@ -57,10 +57,10 @@ void QJSONHighlighter::highlightBlock(const QString& text)
     {
         auto match = matchIterator.next();
 
-        setFormat(
+        setStyleFormat(
             match.capturedStart(1),
             match.capturedLength(1),
-            syntaxStyle()->getFormat("Keyword")
+            "Keyword"
         );
     }
 }
@@ -8,6 +8,8 @@
 QLanguage::QLanguage(QIODevice* device, QObject* parent) :
     QObject(parent),
     m_loaded(false),
+    m_lineComment(),
+    m_blockComment(),
     m_list()
 {
     load(device);
@@ -46,6 +48,16 @@ bool QLanguage::load(QIODevice* device)
             {
                 readText = true;
             }
+            else if (reader.name() == "comment")
+            {
+                auto attributes = reader.attributes();
+
+                m_lineComment = attributes.value("line").toString();
+                m_blockComment = {
+                    attributes.value("blockStart").toString(),
+                    attributes.value("blockEnd").toString()
+                };
+            }
         }
         else if (type == QXmlStreamReader::TokenType::Characters &&
                  readText)
@@ -80,3 +92,13 @@ bool QLanguage::isLoaded() const
 {
     return m_loaded;
 }
+
+QString QLanguage::lineComment() const
+{
+    return m_lineComment;
+}
+
+QPair<QString, QString> QLanguage::blockComment() const
+{
+    return m_blockComment;
+}
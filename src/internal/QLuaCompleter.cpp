@@ -1,9 +1,9 @@
 // QCodeEditor
 #include <QLuaCompleter>
 #include <QLanguage>
+#include <QCompletionListModel>
 
 // Qt
-#include <QStringListModel>
 #include <QFile>
 
 QLuaCompleter::QLuaCompleter(QObject *parent) :
@@ -34,9 +34,10 @@ QLuaCompleter::QLuaCompleter(QObject *parent) :
         list.append(names);
     }
 
-    setModel(new QStringListModel(list, this));
+    // Model filters rows by itself
+    setModel(new QCompletionListModel(list, this));
     setCompletionColumn(0);
-    setModelSorting(QCompleter::CaseInsensitivelySortedModel);
+    setCompletionMode(QCompleter::UnfilteredPopupCompletion);
     setCaseSensitivity(Qt::CaseSensitive);
     setWrapAround(true);
 }
@@ -30,6 +30,8 @@ QLuaHighlighter::QLuaHighlighter(QTextDocument* document) :
         return;
     }
 
+    setCommentTokens(language.lineComment(), language.blockComment());
+
     auto keys = language.keys();
     for (auto&& key : keys)
     {
@@ -82,7 +84,7 @@ QLuaHighlighter::QLuaHighlighter(QTextDocument* document) :
      });
 }
 
-void QLuaHighlighter::highlightBlock(const QString& text)
+void QLuaHighlighter::highlightSyntax(const QString& text)
 {
     { // Checking for require
         auto matchIterator = m_requirePattern.globalMatch(text);
@@ -91,16 +93,16 @@ void QLuaHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Preprocessor")
+                "Preprocessor"
             );
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(1),
                 match.capturedLength(1),
-                syntaxStyle()->getFormat("String")
+                "String"
             );
         }
     }
@@ -111,16 +113,16 @@ void QLuaHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Type")
+                "Type"
             );
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(2),
                 match.capturedLength(2),
-                syntaxStyle()->getFormat("Function")
+                "Function"
             );
         }
     }
@@ -131,10 +133,10 @@ void QLuaHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(1),
                 match.capturedLength(1),
-                syntaxStyle()->getFormat("Type")
+                "Type"
             );
         }
     }
@@ -147,10 +149,10 @@ void QLuaHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat(rule.formatName)
+                rule.formatName
             );
         }
     }
@@ -186,11 +188,76 @@ void QLuaHighlighter::highlightBlock(const QString& text)
             matchLength = endIndex - startIndex + match.capturedLength();
         }
 
-        setFormat(
+        setStyleFormat(
             startIndex,
             matchLength,
-            syntaxStyle()->getFormat(blockRules.formatName)
+            blockRules.formatName
         );
         startIndex = text.indexOf(blockRules.startPattern, startIndex + matchLength);
     }
 }
+
+QStyleSyntaxHighlighter::BlockIndentation QLuaHighlighter::blockIndentation(const QString& text,
+                                                                           const QSyntaxBlockData* data) const
+{
+    auto indentation = bracketIndentation(text, data);
+    auto leading = true;
+
+    for (auto i = 0; i < text.size();)
+    {
+        if (!text[i].isLetterOrNumber() && text[i] != '_')
+        {
+            if (!text[i].isSpace())
+            {
+                leading = false;
+            }
+
+            ++i;
+            continue;
+        }
+
+        auto start = i;
+
+        while (i < text.size() &&
+               (text[i].isLetterOrNumber() || text[i] == '_'))
+        {
+            ++i;
+        }
+
+        if (data != nullptr &&
+            data->tokenAt(start) != QSyntaxBlockData::TokenType::Code)
+        {
+            leading = false;
+            continue;
+        }
+
+        auto word = text.midRef(start, i - start);
+
+        if (word == "function" ||
+            word == "then" ||
+            word == "do" ||
+            word == "repeat")
+        {
+            ++indentation.delta;
+        }
+        else if (word == "end" ||
+                 word == "until" ||
+                 word == "elseif")
+        {
+            --indentation.delta;
+
+            if (leading)
+            {
+                --indentation.shift;
+            }
+        }
+        else if (word == "else" && leading)
+        {
+            --indentation.shift;
+        }
+
+        leading = false;
+    }
+
+    return indentation;
+}
@@ -1,9 +1,9 @@
 // QCodeEditor
 #include <QPythonCompleter>
 #include <QLanguage>
+#include <QCompletionListModel>
 
 // Qt
-#include <QStringListModel>
 #include <QFile>
 
 QPythonCompleter::QPythonCompleter(QObject *parent) :
@@ -34,9 +34,10 @@ QPythonCompleter::QPythonCompleter(QObject *parent) :
         list.append(names);
     }
 
-    setModel(new QStringListModel(list, this));
+    // Model filters rows by itself
+    setModel(new QCompletionListModel(list, this));
     setCompletionColumn(0);
-    setModelSorting(QCompleter::CaseInsensitivelySortedModel);
+    setCompletionMode(QCompleter::UnfilteredPopupCompletion);
     setCaseSensitivity(Qt::CaseSensitive);
     setWrapAround(true);
 }
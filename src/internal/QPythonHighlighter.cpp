@@ -30,6 +30,8 @@ QPythonHighlighter::QPythonHighlighter(QTextDocument* document) :
         return;
     }
 
+    setCommentTokens(language.lineComment(), language.blockComment());
+
     auto keys = language.keys();
     for (auto&& key : keys)
     {
@@ -81,7 +83,7 @@ QPythonHighlighter::QPythonHighlighter(QTextDocument* document) :
      });
 }
 
-void QPythonHighlighter::highlightBlock(const QString& text)
+void QPythonHighlighter::highlightSyntax(const QString& text)
 {
     // Checking for function
     {
@@ -91,16 +93,16 @@ void QPythonHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Type")
+                "Type"
             );
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(2),
                 match.capturedLength(2),
-                syntaxStyle()->getFormat("Function")
+                "Function"
             );
         }
     }
@@ -113,10 +115,10 @@ void QPythonHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            setStyleFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat(rule.formatName)
+                rule.formatName
             );
         }
     }
@@ -153,11 +155,36 @@ void QPythonHighlighter::highlightBlock(const QString& text)
             matchLength = endIndex - startIndex + match.capturedLength();
         }
 
-        setFormat(
+        setStyleFormat(
             startIndex,
             matchLength,
-            syntaxStyle()->getFormat(blockRules.formatName)
+            blockRules.formatName
         );
         startIndex = text.indexOf(blockRules.startPattern, startIndex + matchLength);
     }
 }
+
+QStyleSyntaxHighlighter::BlockIndentation QPythonHighlighter::blockIndentation(const QString& text,
+                                                                              const QSyntaxBlockData* data) const
+{
+    auto indentation = bracketIndentation(text, data);
+
+    // Searching for last code character
+    for (auto i = text.size() - 1; i >= 0; --i)
+    {
+        if (text[i].isSpace() ||
+            (data != nullptr &&
+             data->tokenAt(i) == QSyntaxBlockData::TokenType::Comment))
+        {
+            continue;
+        }
+
+        indentation.header = text[i] == ':' &&
+            (data == nullptr ||
+             data->tokenAt(i) == QSyntaxBlockData::TokenType::Code);
+
+        break;
+    }
+
+    return indentation;
+}
@@ -0,0 +1,201 @@
+// QCodeEditor
+#include <QSnippet>
+
+// Qt
+#include <QHash>
+
+// C++ STL
+#include <algorithm>
+
+QSnippet::QSnippet(const QString& snippet) :
+    m_text(),
+    m_tabStops()
+{
+    m_text.reserve(snippet.size());
+
+    // Number and start of placeholder, that's being read
+    auto placeholder = -1;
+    auto placeholderStart = 0;
+    auto hasFinalStop = false;
+
+    // Index of placeholder, that contains tab stop, or -1.
+    // Tab stops inside of placeholder are added before it
+    QVector<int> parents;
+    auto placeholderFirst = 0;
+
+    auto appendPlaceholder = [&]()
+    {
+        for (auto i = placeholderFirst; i < m_tabStops.size(); ++i)
+        {
+            parents[i] = m_tabStops.size();
+        }
+
+        m_tabStops.append({
+            placeholder,
+            placeholderStart,
+            m_text.size() - placeholderStart
+        });
+        parents.append(-1);
+
+        hasFinalStop = hasFinalStop || placeholder == 0;
+        placeholder = -1;
+    };
+
+    for (auto i = 0; i < snippet.size(); ++i)
+    {
+        auto c = snippet[i];
+
+        if (c == '\\' && i + 1 < snippet.size())
+        {
+            m_text += snippet[++i];
+            continue;
+        }
+
+        if (c == '}' && placeholder >= 0)
+        {
+            appendPlaceholder();
+            continue;
+        }
+
+        if (c != '$' || i + 1 >= snippet.size())
+        {
+            m_text += c;
+            continue;
+        }
+
+        auto position = i + 1;
+
+        if (snippet[position] == '{' && placeholder < 0)
+        {
+            ++position;
+
+            auto number = readNumber(snippet, position);
+
+            if (number >= 0 && position < snippet.size() &&
+                (snippet[position] == ':' || snippet[position] == '}'))
+            {
+                placeholder = number;
+                placeholderStart = m_text.size();
+                placeholderFirst = m_tabStops.size();
+
+                // `}` is read by next iteration
+                i = snippet[position] == ':' ? position : position - 1;
+                continue;
+            }
+        }
+        else
+        {
+            auto number = readNumber(snippet, position);
+
+            if (number >= 0)
+            {
+                m_tabStops.append({number, m_text.size(), 0});
+                parents.append(-1);
+
+                hasFinalStop = hasFinalStop || number == 0;
+                i = position - 1;
+                continue;
+            }
+        }
+
+        m_text += c;
+    }
+
+    // Unclosed placeholder
+    if (placeholder >= 0)
+    {
+        appendPlaceholder();
+    }
+
+    if (!hasFinalStop)
+    {
+        m_tabStops.append({0, m_text.size(), 0});
+        parents.append(-1);
+    }
+
+    fillMirrors(parents);
+
+    // Tab stops inside of placeholder stay before it
+    std::stable_sort(
+        m_tabStops.begin(),
+        m_tabStops.end(),
+        [](const TabStop& a, const TabStop& b)
+        {
+            return a.start < b.start;
+        }
+    );
+}
+
+const QString& QSnippet::text() const
+{
+    return m_text;
+}
+
+const QVector<QSnippet::TabStop>& QSnippet::tabStops() const
+{
+    return m_tabStops;
+}
+
+void QSnippet::fillMirrors(const QVector<int>& parents)
+{
+    QHash<int, QString> placeholders;
+
+    for (auto& stop : m_tabStops)
+    {
+        if (stop.length > 0 && !placeholders.contains(stop.number))
+        {
+            placeholders.insert(stop.number, m_text.mid(stop.start, stop.length));
+        }
+    }
+
+    if (placeholders.isEmpty())
+    {
+        return;
+    }
+
+    for (auto i = 0; i < m_tabStops.size(); ++i)
+    {
+        auto& mirror = m_tabStops[i];
+
+        if (mirror.length > 0 || !placeholders.contains(mirror.number))
+        {
+            continue;
+        }
+
+        auto& placeholder = placeholders[mirror.number];
+        auto position = mirror.start;
+
+        m_text.insert(position, placeholder);
+        mirror.length = placeholder.size();
+
+        for (auto j = 0; j < m_tabStops.size(); ++j)
+        {
+            auto& stop = m_tabStops[j];
+
+            if (j == parents[i])
+            {
+                // Placeholder contains mirror
+                stop.length += placeholder.size();
+            }
+            else if (j != i &&
+                     (stop.start > position ||
+                      (stop.start == position && j > i)))
+            {
+                stop.start += placeholder.size();
+            }
+        }
+    }
+}
+
+int QSnippet::readNumber(const QString& snippet, int& position)
+{
+    auto number = -1;
+
+    while (position < snippet.size() && snippet[position].isDigit())
+    {
+        number = std::max(number, 0) * 10 + snippet[position].digitValue();
+        ++position;
+    }
+
+    return number;
+}
@@ -1,9 +1,39 @@
 // QCodeEditor
 #include <QStyleSyntaxHighlighter>
+#include <QSyntaxStyle>
+#include <QBracketIndex>
+#include <QSyntaxParser>
+#include <QInlineHintIndex>
+#include <QTracer>
 
-QStyleSyntaxHighlighter::QStyleSyntaxHighlighter(QTextDocument* document) : 
+// Qt
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QElapsedTimer>
+
+// C++ STL
+#include <algorithm>
+#include <limits>
+
+QStyleSyntaxHighlighter::QStyleSyntaxHighlighter(QTextDocument* document) :
     QSyntaxHighlighter(document),
-    m_syntaxStyle(nullptr)
+    m_syntaxStyle(nullptr),
+    m_rainbowParentheses(false),
+    m_rainbowFormats(),
+    m_bracketIndex(new QBracketIndex()),
+    m_elementIndex(),
+    m_parser(nullptr),
+    m_parserDocument(),
+    m_parsedChange(-1, -1),
+    m_parsedChangeDepth(0),
+    m_inlineHints(nullptr),
+    m_tracer(nullptr),
+    m_lineComment(),
+    m_blockComment(),
+    m_highlightingDeferred(false),
+    m_pendingStart(),
+    m_pendingEnd(),
+    m_tokens()
 {
 
 }
@@ -11,9 +41,723 @@ QStyleSyntaxHighlighter::QStyleSyntaxHighlighter(QTextDocument* document) :
 void QStyleSyntaxHighlighter::setSyntaxStyle(QSyntaxStyle* style)
 {
     m_syntaxStyle = style;
+
+    m_rainbowFormats.clear();
+
+    if (m_syntaxStyle == nullptr)
+    {
+        return;
+    }
+
+    for (auto level = 1;
+         m_syntaxStyle->hasFormat(QString("Parentheses%1").arg(level));
+         ++level)
+    {
+        m_rainbowFormats.append(
+            m_syntaxStyle->getFormat(QString("Parentheses%1").arg(level))
+        );
+    }
 }
 
 QSyntaxStyle* QStyleSyntaxHighlighter::syntaxStyle() const
 {
     return m_syntaxStyle;
 }
+
+QBracketIndex* QStyleSyntaxHighlighter::bracketIndex() const
+{
+    return m_bracketIndex.data();
+}
+
+QBracketIndex* QStyleSyntaxHighlighter::elementIndex() const
+{
+    return m_elementIndex.data();
+}
+
+void QStyleSyntaxHighlighter::setRainbowParentheses(bool enabled)
+{
+    m_rainbowParentheses = enabled;
+}
+
+bool QStyleSyntaxHighlighter::rainbowParentheses() const
+{
+    return m_rainbowParentheses;
+}
+
+void QStyleSyntaxHighlighter::setParser(QSyntaxParser* parser)
+{
+    if (m_parserDocument)
+    {
+        disconnect(
+            m_parserDocument,
+            &QTextDocument::contentsChange,
+            this,
+            &QStyleSyntaxHighlighter::onContentsChange
+        );
+
+        disconnect(
+            m_parserDocument,
+            &QTextDocument::contentsChange,
+            this,
+            &QStyleSyntaxHighlighter::onContentsChanged
+        );
+    }
+
+    auto currentDocument = document();
+
+    m_parser = parser;
+    m_parserDocument = m_parser ? currentDocument : nullptr;
+    m_parsedChange = {-1, -1};
+    m_parsedChangeDepth = 0;
+
+    if (m_parser)
+    {
+        m_parser->reset(currentDocument);
+    }
+
+    // Parser has to be connected before QSyntaxHighlighter,
+    // so document is detached while connecting. Document
+    // is rehighlighted after it's attached again
+    QSyntaxHighlighter::setDocument(nullptr);
+
+    if (m_parserDocument)
+    {
+        connect(
+            m_parserDocument,
+            &QTextDocument::contentsChange,
+            this,
+            &QStyleSyntaxHighlighter::onContentsChange
+        );
+    }
+
+    QSyntaxHighlighter::setDocument(currentDocument);
+
+    if (m_parserDocument)
+    {
+        connect(
+            m_parserDocument,
+            &QTextDocument::contentsChange,
+            this,
+            &QStyleSyntaxHighlighter::onContentsChanged
+        );
+    }
+}
+
+QSyntaxParser* QStyleSyntaxHighlighter::parser() const
+{
+    return m_parser;
+}
+
+void QStyleSyntaxHighlighter::setInlineHints(const QInlineHintIndex* hints)
+{
+    m_inlineHints = hints;
+}
+
+void QStyleSyntaxHighlighter::setTracer(QTracer* tracer)
+{
+    m_tracer = tracer;
+}
+
+void QStyleSyntaxHighlighter::setCommentTokens(const QString& lineComment,
+                                               const QPair<QString, QString>& blockComment)
+{
+    m_lineComment = lineComment;
+    m_blockComment = blockComment;
+}
+
+QString QStyleSyntaxHighlighter::lineComment() const
+{
+    return m_lineComment;
+}
+
+QPair<QString, QString> QStyleSyntaxHighlighter::blockComment() const
+{
+    return m_blockComment;
+}
+
+void QStyleSyntaxHighlighter::setHighlightingDeferred(bool deferred)
+{
+    m_highlightingDeferred = deferred;
+}
+
+bool QStyleSyntaxHighlighter::hasPendingBlocks() const
+{
+    // Range of previous document isn't pending
+    return !m_pendingStart.isNull() &&
+           m_pendingStart.document() == document();
+}
+
+bool QStyleSyntaxHighlighter::highlightPendingBlocks(int msec)
+{
+    // Number of blocks, that are highlighted between
+    // time limit checks
+    static const int chunkSize = 64;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (hasPendingBlocks() && !timer.hasExpired(msec))
+    {
+        auto block = m_pendingStart.block();
+
+        for (auto i = 0; i < chunkSize && hasPendingBlocks(); ++i)
+        {
+            auto next = block.next();
+
+            // Block is taken out of pending range before
+            // pass, so it's highlighted instead of skipped
+            if (!next.isValid() ||
+                block.position() >= m_pendingEnd.block().position())
+            {
+                m_pendingStart = m_pendingEnd = QTextCursor();
+            }
+            else
+            {
+                m_pendingStart.setPosition(next.position());
+            }
+
+            // Changed block state continues pass until
+            // the first pending block
+            rehighlightBlock(block);
+
+            block = next;
+        }
+    }
+
+    return hasPendingBlocks();
+}
+
+void QStyleSyntaxHighlighter::highlightPendingBlocks()
+{
+    while (hasPendingBlocks())
+    {
+        highlightPendingBlocks(std::numeric_limits<int>::max());
+    }
+}
+
+QVector<int> QStyleSyntaxHighlighter::indentationLevels(int tabWidth) const
+{
+    QVector<int> levels;
+
+    if (document() == nullptr)
+    {
+        return levels;
+    }
+
+    levels.reserve(document()->blockCount());
+
+    // Original width and level of header blocks
+    QVector<QPair<int, int>> headers;
+
+    auto level = 0;
+    auto depth = 0;
+    auto continued = false;
+
+    for (auto block = document()->begin(); block.isValid(); block = block.next())
+    {
+        auto text = block.text();
+        auto data = dynamic_cast<QSyntaxBlockData*>(block.userData());
+
+        if (data != nullptr &&
+            data->index() != m_bracketIndex.data())
+        {
+            data = nullptr;
+        }
+
+        // Block starts inside multiline string or comment
+        auto inside = continued;
+        continued = decodeState(block.userState()) > 0;
+
+        auto first = 0;
+        auto width = 0;
+
+        for (; first < text.size(); ++first)
+        {
+            if (text[first] == '\t')
+            {
+                width += tabWidth - width % std::max(tabWidth, 1);
+            }
+            else if (text[first] == ' ')
+            {
+                ++width;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        if (first == text.size())
+        {
+            levels.append(-1);
+            continue;
+        }
+
+        auto indentation = blockIndentation(text, data);
+
+        if (inside)
+        {
+            levels.append(-1);
+        }
+        else
+        {
+            // Lines inside brackets don't close header blocks
+            while (depth == 0 &&
+                   !headers.empty() &&
+                   width <= headers.last().first)
+            {
+                level = headers.last().second;
+                headers.removeLast();
+            }
+
+            levels.append(std::max(0, level + indentation.shift));
+        }
+
+        level = std::max(0, level + indentation.delta);
+        depth = std::max(0, depth + (data ? data->depthDelta() : 0));
+
+        if (indentation.header && !inside && depth == 0)
+        {
+            headers.append({width, level});
+            ++level;
+        }
+    }
+
+    return levels;
+}
+
+void QStyleSyntaxHighlighter::highlightBlock(const QString& text)
+{
+    if (m_highlightingDeferred || hasPendingBlocks())
+    {
+        auto position = currentBlock().position();
+
+        if (m_highlightingDeferred)
+        {
+            if (!hasPendingBlocks())
+            {
+                m_pendingStart = QTextCursor(document());
+                m_pendingStart.setPosition(position);
+
+                m_pendingEnd = QTextCursor(document());
+                m_pendingEnd.setPosition(position);
+
+                // Text inserted before the first pending
+                // block stays outside of pending range
+                m_pendingStart.setKeepPositionOnInsert(true);
+            }
+
+            if (position < m_pendingStart.block().position())
+            {
+                m_pendingStart.setPosition(position);
+            }
+
+            if (position > m_pendingEnd.position())
+            {
+                m_pendingEnd.setPosition(position);
+            }
+        }
+
+        // Unchanged block state stops QSyntaxHighlighter
+        if (position >= m_pendingStart.block().position() &&
+            position <= m_pendingEnd.position())
+        {
+            return;
+        }
+    }
+
+    // Skipped pending blocks aren't traced
+    QTracer::Span span(m_tracer, "highlightBlock");
+
+    m_tokens.fill(QSyntaxBlockData::TokenType::Code, text.size());
+
+    if (m_parser && m_parserDocument == document())
+    {
+        highlightParsed(text);
+    }
+    else
+    {
+        highlightSyntax(text);
+    }
+
+    auto data = updateBlockData(text);
+
+    if (m_elementIndex)
+    {
+        updateElementData(data, text);
+    }
+
+    auto rainbow = m_rainbowParentheses && !m_rainbowFormats.empty();
+    auto depth = 0;
+
+    if (rainbow)
+    {
+        depth = m_bracketIndex->depthBefore(data);
+
+        highlightRainbow(data, depth);
+
+        depth += data->depthDelta();
+    }
+
+    if (m_inlineHints && m_inlineHints->size())
+    {
+        reserveInlineHints(text);
+    }
+
+    QSyntaxHighlighter::setCurrentBlockState(
+        encodeState(currentBlockState(), depth)
+    );
+}
+
+void QStyleSyntaxHighlighter::highlightSyntax(const QString&)
+{
+
+}
+
+void QStyleSyntaxHighlighter::setStyleFormat(int start, int count, const QString& formatName)
+{
+    setFormat(start, count, m_syntaxStyle->getFormat(formatName));
+
+    // Same bounds as QSyntaxHighlighter::setFormat
+    if (start < 0 || start >= m_tokens.size())
+    {
+        return;
+    }
+
+    auto type = QSyntaxBlockData::TokenType::Code;
+
+    if (formatName == "String")
+    {
+        type = QSyntaxBlockData::TokenType::String;
+    }
+    else if (formatName == "Comment")
+    {
+        type = QSyntaxBlockData::TokenType::Comment;
+    }
+
+    auto end = std::min(start + count, m_tokens.size());
+
+    std::fill(m_tokens.begin() + start, m_tokens.begin() + end, type);
+}
+
+bool QStyleSyntaxHighlighter::isClosingBlock(const QTextBlock& block) const
+{
+    auto data = dynamic_cast<QSyntaxBlockData*>(block.userData());
+
+    if (data != nullptr &&
+        data->index() != m_bracketIndex.data())
+    {
+        data = nullptr;
+    }
+
+    return blockIndentation(block.text(), data).shift < 0;
+}
+
+void QStyleSyntaxHighlighter::setElementIndexEnabled(bool enabled)
+{
+    if (enabled == !m_elementIndex.isNull())
+    {
+        return;
+    }
+
+    // Nodes of previous index are replaced on next highlighting
+    m_elementIndex.reset(enabled ? new QBracketIndex() : nullptr);
+}
+
+QVector<QSyntaxBlockData::Bracket> QStyleSyntaxHighlighter::blockElements(const QString&,
+                                                                          const QSyntaxBlockData*) const
+{
+    return {};
+}
+
+QStyleSyntaxHighlighter::BlockIndentation QStyleSyntaxHighlighter::blockIndentation(const QString& text,
+                                                                                   const QSyntaxBlockData* data) const
+{
+    return bracketIndentation(text, data);
+}
+
+QStyleSyntaxHighlighter::BlockIndentation QStyleSyntaxHighlighter::bracketIndentation(const QString& text,
+                                                                                     const QSyntaxBlockData* data)
+{
+    BlockIndentation indentation{0, 0, false};
+
+    if (data == nullptr)
+    {
+        return indentation;
+    }
+
+    indentation.delta = data->depthDelta();
+
+    auto skipSpaces = [&text](int position)
+    {
+        while (position < text.size() && text[position].isSpace())
+        {
+            ++position;
+        }
+
+        return position;
+    };
+
+    auto position = skipSpaces(0);
+
+    // Leading closing brackets belong to outer level
+    for (auto& bracket : data->brackets())
+    {
+        if (bracket.position != position ||
+            QSyntaxBlockData::isOpeningBracket(bracket.character))
+        {
+            break;
+        }
+
+        --indentation.shift;
+        position = skipSpaces(bracket.position + 1);
+    }
+
+    return indentation;
+}
+
+int QStyleSyntaxHighlighter::previousBlockState() const
+{
+    return decodeState(QSyntaxHighlighter::previousBlockState());
+}
+
+int QStyleSyntaxHighlighter::currentBlockState() const
+{
+    return decodeState(QSyntaxHighlighter::currentBlockState());
+}
+
+void QStyleSyntaxHighlighter::setCurrentBlockState(int newState)
+{
+    QSyntaxHighlighter::setCurrentBlockState(encodeState(newState, 0));
+}
+
+int QStyleSyntaxHighlighter::encodeState(int state, int depth)
+{
+    // Highlighter state is kept in low 16 bits, -1 included.
+    // Depth is kept signed in 15 bits, so depth changes after
+    // unmatched closing brackets update following blocks too
+    return ((depth & 0x7FFF) << 16) | ((state + 1) & 0xFFFF);
+}
+
+int QStyleSyntaxHighlighter::decodeState(int blockState)
+{
+    if (blockState < 0)
+    {
+        return -1;
+    }
+
+    return (blockState & 0xFFFF) - 1;
+}
+
+QSyntaxBlockData* QStyleSyntaxHighlighter::updateBlockData(const QString& text)
+{
+    auto data = dynamic_cast<QSyntaxBlockData*>(currentBlockUserData());
+
+    if (data == nullptr ||
+        data->index() != m_bracketIndex.data())
+    {
+        // Searching for previous indexed block
+        QSyntaxBlockData* previous = nullptr;
+
+        for (auto block = currentBlock().previous();
+             block.isValid();
+             block = block.previous())
+        {
+            auto previousData = dynamic_cast<QSyntaxBlockData*>(block.userData());
+
+            if (previousData != nullptr &&
+                previousData->index() == m_bracketIndex.data())
+            {
+                previous = previousData;
+                break;
+            }
+        }
+
+        data = new QSyntaxBlockData(m_bracketIndex);
+        m_bracketIndex->insert(data, previous);
+
+        // Previous data (if any) is deleted by block
+        setCurrentBlockUserData(data);
+    }
+
+    QVector<QSyntaxBlockData::Bracket> brackets;
+    QVector<QSyntaxBlockData::TokenSpan> spans;
+
+    for (auto i = 0; i < text.size(); ++i)
+    {
+        auto type = m_tokens[i];
+
+        if (type == QSyntaxBlockData::TokenType::Code)
+        {
+            if (QSyntaxBlockData::isBracket(text[i]))
+            {
+                brackets.append({i, text[i]});
+            }
+        }
+        else if (!spans.empty() &&
+                 spans.last().type == type &&
+                 spans.last().start + spans.last().length == i)
+        {
+            ++spans.last().length;
+        }
+        else
+        {
+            spans.append({i, 1, type});
+        }
+    }
+
+    data->setBrackets(std::move(brackets));
+    data->setTokenSpans(std::move(spans));
+    m_bracketIndex->update(data);
+
+    return data;
+}
+
+void QStyleSyntaxHighlighter::updateElementData(QSyntaxBlockData* data, const QString& text)
+{
+    auto elementData = data->elementData();
+
+    if (elementData == nullptr ||
+        elementData->index() != m_elementIndex.data())
+    {
+        // Searching for previous indexed block
+        QSyntaxBlockData* previous = nullptr;
+
+        for (auto block = currentBlock().previous();
+             block.isValid();
+             block = block.previous())
+        {
+            auto previousData = dynamic_cast<QSyntaxBlockData*>(block.userData());
+
+            if (previousData != nullptr &&
+                previousData->elementData() != nullptr &&
+                previousData->elementData()->index() == m_elementIndex.data())
+            {
+                previous = previousData->elementData();
+                break;
+            }
+        }
+
+        elementData = new QSyntaxBlockData(m_elementIndex);
+        m_elementIndex->insert(elementData, previous);
+
+        // Previous element data (if any) is deleted
+        data->setElementData(elementData);
+    }
+
+    elementData->setBrackets(blockElements(text, data));
+    m_elementIndex->update(elementData);
+}
+
+void QStyleSyntaxHighlighter::highlightRainbow(const QSyntaxBlockData* data, int depth)
+{
+    for (auto& bracket : data->brackets())
+    {
+        auto opening = QSyntaxBlockData::isOpeningBracket(bracket.character);
+
+        // Closing bracket has depth of it's pair
+        if (!opening)
+        {
+            --depth;
+        }
+
+        // Depth is negative after unmatched closing brackets
+        auto level = depth % m_rainbowFormats.size();
+
+        if (level < 0)
+        {
+            level += m_rainbowFormats.size();
+        }
+
+        setFormat(bracket.position, 1, m_rainbowFormats[level]);
+
+        if (opening)
+        {
+            ++depth;
+        }
+    }
+}
+
+void QStyleSyntaxHighlighter::highlightParsed(const QString& text)
+{
+    auto blockPosition = currentBlock().position();
+
+    for (auto& span : m_parser->spans(blockPosition, blockPosition + text.size()))
+    {
+        auto start = std::max(span.start - blockPosition, 0);
+        auto end = std::min(span.start + span.length - blockPosition, text.size());
+
+        if (start < end)
+        {
+            setStyleFormat(start, end - start, span.formatName);
+        }
+    }
+}
+
+void QStyleSyntaxHighlighter::onContentsChange(int position, int charsRemoved, int charsAdded)
+{
+    // Nested changes are format changes made while
+    // highlighting, they don't change parsed text
+    if (m_parsedChangeDepth++ > 0 ||
+        sender() != document())
+    {
+        return;
+    }
+
+    m_parsedChange = m_parser->edit(document(), position, charsRemoved, charsAdded);
+}
+
+void QStyleSyntaxHighlighter::onContentsChanged(int position, int, int charsAdded)
+{
+    if (--m_parsedChangeDepth > 0 ||
+        sender() != document())
+    {
+        return;
+    }
+
+    auto change = m_parsedChange;
+
+    m_parsedChange = {-1, -1};
+
+    if (change.first < 0 || change.second < 0)
+    {
+        return;
+    }
+
+    // Edited blocks are already highlighted
+    auto editedFirst = document()->findBlock(position);
+    auto editedLast = document()->findBlock(position + charsAdded);
+
+    for (auto block = document()->findBlock(change.first);
+         block.isValid() && block.position() < change.second;
+         block = block.next())
+    {
+        if (editedFirst.isValid() &&
+            editedLast.isValid() &&
+            block.blockNumber() >= editedFirst.blockNumber() &&
+            block.blockNumber() <= editedLast.blockNumber())
+        {
+            continue;
+        }
+
+        rehighlightBlock(block);
+    }
+}
+
+void QStyleSyntaxHighlighter::reserveInlineHints(const QString& text)
+{
+    auto blockPosition = currentBlock().position();
+
+    // Hint at block start has no previous character
+    for (auto& entry : m_inlineHints->hints(blockPosition + 1,
+                                            blockPosition + text.size()))
+    {
+        auto index = entry.hint.position - blockPosition - 1;
+        auto charFormat = format(index);
+
+        charFormat.setFontLetterSpacingType(QFont::AbsoluteSpacing);
+        charFormat.setFontLetterSpacing(entry.width);
+
+        setFormat(index, 1, charFormat);
+    }
+}
@@ -0,0 +1,138 @@
+// QCodeEditor
+#include <QSyntaxBlockData>
+#include <QBracketIndex>
+
+// C++ STL
+#include <algorithm>
+
+QSyntaxBlockData::QSyntaxBlockData(QSharedPointer<QBracketIndex> index) :
+    QTextBlockUserData(),
+    m_index(std::move(index)),
+    m_brackets(),
+    m_tokenSpans(),
+    m_depthDelta(0),
+    m_minimumDepth(0),
+    m_elementData(),
+    m_parent(nullptr),
+    m_left(nullptr),
+    m_right(nullptr),
+    m_priority(0),
+    m_size(1),
+    m_totalDelta(0),
+    m_totalMinimum(0)
+{
+
+}
+
+QSyntaxBlockData::~QSyntaxBlockData()
+{
+    if (m_index)
+    {
+        m_index->remove(this);
+    }
+}
+
+QBracketIndex* QSyntaxBlockData::index() const
+{
+    return m_index.data();
+}
+
+const QVector<QSyntaxBlockData::Bracket>& QSyntaxBlockData::brackets() const
+{
+    return m_brackets;
+}
+
+void QSyntaxBlockData::setBrackets(QVector<Bracket> brackets)
+{
+    m_brackets = std::move(brackets);
+    m_depthDelta = 0;
+    m_minimumDepth = 0;
+
+    for (auto& bracket : m_brackets)
+    {
+        m_depthDelta += isOpeningBracket(bracket.character) ? 1 : -1;
+        m_minimumDepth = std::min(m_minimumDepth, m_depthDelta);
+    }
+}
+
+const QVector<QSyntaxBlockData::TokenSpan>& QSyntaxBlockData::tokenSpans() const
+{
+    return m_tokenSpans;
+}
+
+void QSyntaxBlockData::setTokenSpans(QVector<TokenSpan> spans)
+{
+    m_tokenSpans = std::move(spans);
+}
+
+QSyntaxBlockData::TokenType QSyntaxBlockData::tokenAt(int positionInBlock) const
+{
+    auto span = tokenSpanAt(positionInBlock);
+
+    return span ? span->type : TokenType::Code;
+}
+
+const QSyntaxBlockData::TokenSpan* QSyntaxBlockData::tokenSpanAt(int positionInBlock) const
+{
+    // First span, that ends after position
+    auto span = std::lower_bound(
+        m_tokenSpans.begin(),
+        m_tokenSpans.end(),
+        positionInBlock,
+        [](const TokenSpan& s, int position)
+        { return s.start + s.length <= position; }
+    );
+
+    if (span == m_tokenSpans.end() ||
+        span->start > positionInBlock)
+    {
+        return nullptr;
+    }
+
+    return &(*span);
+}
+
+int QSyntaxBlockData::depthDelta() const
+{
+    return m_depthDelta;
+}
+
+int QSyntaxBlockData::minimumDepth() const
+{
+    return m_minimumDepth;
+}
+
+QSyntaxBlockData* QSyntaxBlockData::elementData() const
+{
+    return m_elementData.data();
+}
+
+void QSyntaxBlockData::setElementData(QSyntaxBlockData* data)
+{
+    m_elementData.reset(data);
+}
+
+bool QSyntaxBlockData::isBracket(QChar c)
+{
+    return !pairBracket(c).isNull();
+}
+
+bool QSyntaxBlockData::isOpeningBracket(QChar c)
+{
+    return c == '(' || c == '{' || c == '[';
+}
+
+QChar QSyntaxBlockData::pairBracket(QChar c)
+{
+    switch (c.unicode())
+    {
+    case '(': return ')';
+    case ')': return '(';
+    case '{': return '}';
+    case '}': return '{';
+    case '[': return ']';
+    case ']': return '[';
+    default:
+        return {};
+    }
+}
@@ -131,6 +131,11 @@ QTextCharFormat QSyntaxStyle::getFormat(QString name) const
     return result.value();
 }
 
+bool QSyntaxStyle::hasFormat(QString name) const
+{
+    return m_data.contains(name);
+}
+
 bool QSyntaxStyle::isLoaded() const
 {
     return m_loaded;
@@ -0,0 +1,557 @@
+// QCodeEditor
+#include <QSyntaxTree>
+#include <QSyntaxBlockData>
+#include <QBracketIndex>
+#include <QSyntaxParser>
+#include <QStyleSyntaxHighlighter>
+
+// Qt
+#include <QTextDocument>
+
+// C++ STL
+#include <algorithm>
+
+namespace
+{
+    bool isWordCharacter(QChar c)
+    {
+        return c.isLetterOrNumber() || c == '_';
+    }
+}
+
+QSyntaxTree::QSyntaxTree(const QTextDocument* document,
+                         const QBracketIndex* index,
+                         const QSyntaxParser* parser,
+                         const QBracketIndex* elementIndex,
+                         const QStyleSyntaxHighlighter* highlighter) :
+    m_document(document),
+    m_index(index),
+    m_parser(parser),
+    m_elementIndex(elementIndex),
+    m_highlighter(highlighter)
+{
+
+}
+
+QSyntaxTree::Node QSyntaxTree::nodeAt(int position) const
+{
+    return parentNode(position, position);
+}
+
+QSyntaxTree::Node QSyntaxTree::parentNode(int start, int end) const
+{
+    auto node = textNode(start, end);
+
+    if (m_parser == nullptr)
+    {
+        return node;
+    }
+
+    auto range = m_parser->parentNode(start, end);
+
+    // Parser node has to be bigger than range
+    if (range.first < 0 ||
+        range.second < 0 ||
+        range.first > start ||
+        range.second < end ||
+        range.second - range.first <= end - start)
+    {
+        return node;
+    }
+
+    if (node.isValid() &&
+        node.end - node.start <= range.second - range.first)
+    {
+        return node;
+    }
+
+    return {NodeType::Parsed, range.first, range.second};
+}
+
+QSyntaxTree::Node QSyntaxTree::textNode(int start, int end) const
+{
+    auto contains = [start, end](const Node& node)
+    {
+        return node.isValid() &&
+               node.start <= start &&
+               node.end >= end &&
+               node.end - node.start > end - start;
+    };
+
+    auto node = wordNode(start, end);
+    if (contains(node))
+    {
+        return node;
+    }
+
+    node = tokenNode(start, end);
+    if (contains(node))
+    {
+        return node;
+    }
+
+    if (m_index)
+    {
+        auto brackets = enclosingBrackets(start);
+
+        // Brackets have to contain whole range
+        while (brackets.first >= 0 &&
+               brackets.second >= 0 &&
+               brackets.second < end)
+        {
+            brackets = enclosingBrackets(brackets.first);
+        }
+
+        while (brackets.first >= 0 &&
+               brackets.second >= 0)
+        {
+            auto candidates = {
+                segmentNode(brackets.first + 1, brackets.second, start, end),
+                trimmed(NodeType::Contents, brackets.first + 1, brackets.second),
+                Node{NodeType::Brackets, brackets.first, brackets.second + 1}
+            };
+
+            for (auto& candidate : candidates)
+            {
+                if (contains(candidate))
+                {
+                    return candidate;
+                }
+            }
+
+            brackets = enclosingBrackets(brackets.first);
+        }
+    }
+
+    if (m_elementIndex)
+    {
+        auto element = enclosingElement(start);
+
+        // Element has to contain whole range
+        while (element.first >= 0 &&
+               element.second >= 0 &&
+               findTagEnd(element.second) + 1 < end)
+        {
+            element = enclosingElement(element.first);
+        }
+
+        while (element.first >= 0 &&
+               element.second >= 0)
+        {
+            auto openingEnd = findTagEnd(element.first);
+            auto closingEnd = findTagEnd(element.second);
+
+            // Self closing tag has no contents
+            if (openingEnd >= 0 &&
+                openingEnd < element.second)
+            {
+                node = trimmed(NodeType::Contents, openingEnd + 1, element.second);
+
+                if (contains(node))
+                {
+                    return node;
+                }
+            }
+
+            if (closingEnd >= 0)
+            {
+                node = {NodeType::Element, element.first, closingEnd + 1};
+
+                if (contains(node))
+                {
+                    return node;
+                }
+            }
+
+            element = enclosingElement(element.first);
+        }
+    }
+
+    node = linesNode(start, end);
+    if (contains(node))
+    {
+        return node;
+    }
+
+    node = indentationNode(start, end);
+    if (contains(node))
+    {
+        return node;
+    }
+
+    node = {NodeType::Document, 0, std::max(0, m_document->characterCount() - 1)};
+    if (contains(node))
+    {
+        return node;
+    }
+
+    return {NodeType::Invalid, -1, -1};
+}
+
+const QSyntaxBlockData* QSyntaxTree::blockData(const QTextBlock& block) const
+{
+    if (m_index == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto data = dynamic_cast<QSyntaxBlockData*>(block.userData());
+
+    if (data == nullptr ||
+        data->index() != m_index)
+    {
+        return nullptr;
+    }
+
+    return data;
+}
+
+QPair<int, int> QSyntaxTree::enclosingBrackets(int position) const
+{
+    auto block = m_document->findBlock(position);
+
+    if (!block.isValid())
+    {
+        return {-1, -1};
+    }
+
+    return m_index->findEnclosingBrackets(block, position - block.position());
+}
+
+QPair<int, int> QSyntaxTree::enclosingElement(int position) const
+{
+    auto block = m_document->findBlock(position);
+
+    if (!block.isValid())
+    {
+        return {-1, -1};
+    }
+
+    return m_elementIndex->findEnclosingBrackets(block, position - block.position());
+}
+
+int QSyntaxTree::findTagEnd(int position) const
+{
+    auto end = m_document->characterCount();
+
+    for (; position < end; ++position)
+    {
+        if (m_document->characterAt(position) == '>')
+        {
+            return position;
+        }
+    }
+
+    return -1;
+}
+
+QSyntaxTree::Node QSyntaxTree::wordNode(int start, int end) const
+{
+    for (auto position = start; position < end; ++position)
+    {
+        if (!isWordCharacter(m_document->characterAt(position)))
+        {
+            return {NodeType::Invalid, -1, -1};
+        }
+    }
+
+    while (start > 0 &&
+           isWordCharacter(m_document->characterAt(start - 1)))
+    {
+        --start;
+    }
+
+    while (isWordCharacter(m_document->characterAt(end)))
+    {
+        ++end;
+    }
+
+    if (start == end)
+    {
+        return {NodeType::Invalid, -1, -1};
+    }
+
+    return {NodeType::Word, start, end};
+}
+
+QSyntaxTree::Node QSyntaxTree::tokenNode(int start, int end) const
+{
+    auto block = m_document->findBlock(start);
+    auto data = blockData(block);
+
+    if (data == nullptr)
+    {
+        return {NodeType::Invalid, -1, -1};
+    }
+
+    auto positionInBlock = start - block.position();
+    auto span = data->tokenSpanAt(positionInBlock);
+
+    // Cursor right after token
+    if (span == nullptr && start == end && positionInBlock > 0)
+    {
+        span = data->tokenSpanAt(positionInBlock - 1);
+    }
+
+    if (span == nullptr)
+    {
+        return {NodeType::Invalid, -1, -1};
+    }
+
+    return {
+        NodeType::Token,
+        block.position() + span->start,
+        block.position() + span->start + span->length
+    };
+}
+
+QSyntaxTree::Node QSyntaxTree::segmentNode(int first, int last, int start, int end) const
+{
+    auto left = findSeparator(start - 1, first - 1, -1);
+    auto right = findSeparator(end, last, 1);
+
+    // Segment is the whole contents
+    if (left == first - 1 && right == last)
+    {
+        return {NodeType::Invalid, -1, -1};
+    }
+
+    return trimmed(NodeType::Segment, left + 1, right);
+}
+
+QSyntaxTree::Node QSyntaxTree::linesNode(int start, int end) const
+{
+    auto first = m_document->findBlock(start);
+    auto last = m_document->findBlock(end > start ? end - 1 : end);
+
+    if (!first.isValid() || !last.isValid())
+    {
+        return {NodeType::Invalid, -1, -1};
+    }
+
+    return trimmed(
+        NodeType::Lines,
+        first.position(),
+        last.position() + last.length() - 1
+    );
+}
+
+QSyntaxTree::Node QSyntaxTree::indentationNode(int start, int end) const
+{
+    auto first = m_document->findBlock(start);
+    auto last = m_document->findBlock(end > start ? end - 1 : end);
+
+    if (!first.isValid() || !last.isValid())
+    {
+        return {NodeType::Invalid, -1, -1};
+    }
+
+    auto level = std::max(0, indentation(first));
+
+    // Header can't have lower indentation than 0
+    while (level > 0)
+    {
+        // Searching for header with lower indentation
+        auto header = first.previous();
+        auto headerLevel = -1;
+
+        while (header.isValid())
+        {
+            headerLevel = indentation(header);
+
+            if (headerLevel >= 0 && headerLevel < level)
+            {
+                break;
+            }
+
+            auto opening = findPairedBlock(header, true);
+
+            header = opening.isValid() ? opening : header.previous();
+        }
+
+        if (!header.isValid())
+        {
+            return {NodeType::Invalid, -1, -1};
+        }
+
+        // Collecting body with higher indentation
+        auto body = header;
+
+        for (auto block = header.next(); block.isValid();)
+        {
+            auto blockLevel = indentation(block);
+
+            if (blockLevel < 0)
+            {
+                block = block.next();
+                continue;
+            }
+
+            if (blockLevel <= headerLevel)
+            {
+                // Closing line of block
+                if (blockLevel == headerLevel &&
+                    isClosingBlock(block, blockLevel))
+                {
+                    body = block;
+                }
+
+                break;
+            }
+
+            body = block;
+
+            auto closing = findPairedBlock(block, false);
+
+            block = closing.isValid() ? closing : block.next();
+        }
+
+        auto node = trimmed(
+            NodeType::IndentationBlock,
+            header.position() + headerLevel,
+            body.position() + body.length() - 1
+        );
+
+        if (node.start <= start &&
+            node.end >= end &&
+            node.end - node.start > end - start)
+        {
+            return node;
+        }
+
+        first = header;
+        level = headerLevel;
+    }
+
+    return {NodeType::Invalid, -1, -1};
+}
+
+QTextBlock QSyntaxTree::findPairedBlock(const QTextBlock& block, bool backward) const
+{
+    auto data = blockData(block);
+
+    if (data == nullptr ||
+        data->brackets().isEmpty())
+    {
+        return QTextBlock();
+    }
+
+    auto& bracket = backward ? data->brackets().first() : data->brackets().last();
+
+    if (QSyntaxBlockData::isOpeningBracket(bracket.character) == backward)
+    {
+        return QTextBlock();
+    }
+
+    auto match = m_index->findMatchingBracket(block, bracket.position);
+
+    if (match < 0 ||
+        (backward ? match >= block.position() : match < block.position() + block.length()))
+    {
+        return QTextBlock();
+    }
+
+    return m_document->findBlock(match);
+}
+
+bool QSyntaxTree::isClosingBlock(const QTextBlock& block, int level) const
+{
+    if (m_highlighter != nullptr)
+    {
+        return m_highlighter->isClosingBlock(block);
+    }
+
+    auto c = m_document->characterAt(block.position() + level);
+
+    return QSyntaxBlockData::isBracket(c) &&
+           !QSyntaxBlockData::isOpeningBracket(c);
+}
+
+int QSyntaxTree::findSeparator(int position, int limit, int direction) const
+{
+    QTextBlock block;
+    QString text;
+    const QSyntaxBlockData* data = nullptr;
+
+    while (direction > 0 ? position < limit : position > limit)
+    {
+        if (!block.isValid() ||
+            position < block.position() ||
+            position >= block.position() + block.length())
+        {
+            block = m_document->findBlock(position);
+
+            if (!block.isValid())
+            {
+                break;
+            }
+
+            text = block.text();
+            data = blockData(block);
+        }
+
+        auto index = position - block.position();
+
+        if (index < text.size() &&
+            (data == nullptr || data->tokenAt(index) == QSyntaxBlockData::TokenType::Code))
+        {
+            auto character = text[index];
+
+            if (character == ',' || character == ';')
+            {
+                return position;
+            }
+
+            // Skipping nested brackets
+            if (QSyntaxBlockData::isBracket(character) &&
+                QSyntaxBlockData::isOpeningBracket(character) == (direction > 0))
+            {
+                auto match = m_index->findMatchingBracket(block, index);
+
+                if (match < 0)
+                {
+                    return limit;
+                }
+
+                position = match;
+            }
+        }
+
+        position += direction;
+    }
+
+    return limit;
+}
+
+QSyntaxTree::Node QSyntaxTree::trimmed(NodeType type, int start, int end) const
+{
+    while (start < end && m_document->characterAt(start).isSpace())
+    {
+        ++start;
+    }
+
+    while (end > start && m_document->characterAt(end - 1).isSpace())
+    {
+        --end;
+    }
+
+    return {type, start, end};
+}
+
+int QSyntaxTree::indentation(const QTextBlock& block) const
+{
+    auto position = block.position();
+    auto end = position + block.length() - 1;
+
+    for (auto i = position; i < end; ++i)
+    {
+        auto c = m_document->characterAt(i);
+
+        if (c != ' ' && c != '\t')
+        {
+            return i - position;
+        }
+    }
+
+    return -1;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+// QCodeEditor
+#include <QTracer>
+
+// Qt
+#include <QFile>
+
+QTracer::Span::Span(QTracer* tracer, const char* name) :
+    m_tracer(tracer),
+    m_name(name),
+    m_start(tracer ? tracer->now() : 0)
+{
+
+}
+
+QTracer::Span::~Span()
+{
+    if (m_tracer)
+    {
+        m_tracer->addSpan(m_name, m_start, m_tracer->now());
+    }
+}
+
+QTracer::QTracer() :
+    m_timer(),
+    m_events()
+{
+    m_timer.start();
+}
+
+qint64 QTracer::now() const
+{
+    return m_timer.nsecsElapsed();
+}
+
+void QTracer::addSpan(const char* name, qint64 start, qint64 end, Track track)
+{
+    m_events.append({name, start, end, track});
+}
+
+void QTracer::clear()
+{
+    m_events.clear();
+}
+
+int QTracer::size() const
+{
+    return m_events.size();
+}
+
+QByteArray QTracer::toJson() const
+{
+    QByteArray json;
+    json.reserve(m_events.size() * 96 + 256);
+
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    // Track names
+    json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+            "\"args\":{\"name\":\"QCodeEditor\"}},";
+    json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,"
+            "\"args\":{\"name\":\"Keystroke latency\"}}";
+
+    // Timestamps are in microseconds
+    for (auto& event : m_events)
+    {
+        json += ",{\"name\":\"";
+        json += event.name;
+        json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+        json += QByteArray::number(static_cast<int>(event.track));
+        json += ",\"ts\":";
+        json += QByteArray::number(event.start / 1000.0, 'f', 3);
+        json += ",\"dur\":";
+        json += QByteArray::number((event.end - event.start) / 1000.0, 'f', 3);
+        json += "}";
+    }
+
+    json += "]}";
+
+    return json;
+}
+
+bool QTracer::save(const QString& fileName) const
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    return file.write(toJson()) >= 0;
+}
@@ -0,0 +1,233 @@
+// QCodeEditor
+#include <QWordIndex>
+
+// Qt
+#include <QTextDocument>
+#include <QTextBlock>
+#include <QHash>
+
+// C++ STL
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+    // Shorter words don't save typing
+    const int minimumWordLength = 3;
+
+    // Blocks around cursor, which words get proximity rank
+    const int proximityBlocks = 64;
+
+    bool isWordCharacter(QChar c)
+    {
+        return c.isLetterOrNumber() || c == '_';
+    }
+}
+
+QWordIndex::QWordIndex() :
+    m_blockWords(),
+    m_frequencies()
+{
+
+}
+
+void QWordIndex::clear()
+{
+    m_blockWords.clear();
+    m_frequencies.clear();
+}
+
+void QWordIndex::rebuild(const QTextDocument* document)
+{
+    clear();
+
+    m_blockWords.reserve(document->blockCount());
+
+    for (auto block = document->begin(); block.isValid(); block = block.next())
+    {
+        m_blockWords.append(blockWords(block.text()));
+        addWords(m_blockWords.last());
+    }
+}
+
+void QWordIndex::update(const QTextDocument* document,
+                        int position,
+                        int charsRemoved,
+                        int charsAdded)
+{
+    Q_UNUSED(charsRemoved)
+
+    auto first = document->findBlock(position);
+    auto last = document->findBlock(position + charsAdded);
+
+    if (!last.isValid())
+    {
+        last = document->lastBlock();
+    }
+
+    if (!first.isValid() || m_blockWords.isEmpty())
+    {
+        rebuild(document);
+        return;
+    }
+
+    // Removed blocks are found from block count change
+    auto firstNumber = first.blockNumber();
+    auto newCount = last.blockNumber() - firstNumber + 1;
+    auto oldCount = newCount + m_blockWords.size() - document->blockCount();
+
+    if (oldCount < 1 ||
+        firstNumber + oldCount > m_blockWords.size())
+    {
+        rebuild(document);
+        return;
+    }
+
+    for (auto i = firstNumber; i < firstNumber + oldCount; ++i)
+    {
+        removeWords(m_blockWords[i]);
+    }
+
+    if (oldCount > newCount)
+    {
+        m_blockWords.remove(firstNumber, oldCount - newCount);
+    }
+    else if (oldCount < newCount)
+    {
+        m_blockWords.insert(firstNumber, newCount - oldCount, QVector<QString>());
+    }
+
+    auto number = firstNumber;
+
+    for (auto block = first; block.isValid(); block = block.next(), ++number)
+    {
+        m_blockWords[number] = blockWords(block.text());
+        addWords(m_blockWords[number]);
+
+        if (block == last)
+        {
+            break;
+        }
+    }
+}
+
+int QWordIndex::frequency(const QString& word) const
+{
+    return m_frequencies.value(word, 0);
+}
+
+QStringList QWordIndex::completions(const QString& prefix, int blockNumber, int limit) const
+{
+    // Nearer blocks give higher proximity
+    QHash<QString, int> proximity;
+
+    auto first = std::max(0, blockNumber - proximityBlocks);
+    auto last = std::min(m_blockWords.size() - 1, blockNumber + proximityBlocks);
+
+    for (auto number = first; number <= last; ++number)
+    {
+        auto rank = proximityBlocks + 1 - std::abs(number - blockNumber);
+
+        for (auto& word : m_blockWords[number])
+        {
+            if (word.size() > prefix.size() &&
+                word.startsWith(prefix))
+            {
+                auto& value = proximity[word];
+                value = std::max(value, rank);
+            }
+        }
+    }
+
+    struct Candidate
+    {
+        int score;
+        QString word;
+    };
+
+    QVector<Candidate> candidates;
+
+    // Words with prefix follow prefix in sorted order
+    for (auto it = m_frequencies.lowerBound(prefix);
+         it != m_frequencies.end() && it.key().startsWith(prefix);
+         ++it)
+    {
+        if (it.key().size() > prefix.size())
+        {
+            candidates.append({it.value() + proximity.value(it.key(), 0), it.key()});
+        }
+    }
+
+    auto count = std::min(limit, candidates.size());
+
+    std::partial_sort(
+        candidates.begin(),
+        candidates.begin() + count,
+        candidates.end(),
+        [](const Candidate& a, const Candidate& b)
+        {
+            return a.score != b.score ? a.score > b.score : a.word < b.word;
+        }
+    );
+
+    QStringList words;
+    words.reserve(count);
+
+    for (auto i = 0; i < count; ++i)
+    {
+        words.append(candidates[i].word);
+    }
+
+    return words;
+}
+
+QVector<QString> QWordIndex::blockWords(const QString& text)
+{
+    QVector<QString> words;
+
+    for (auto i = 0; i < text.size();)
+    {
+        if (!isWordCharacter(text[i]))
+        {
+            ++i;
+            continue;
+        }
+
+        auto start = i;
+
+        while (i < text.size() && isWordCharacter(text[i]))
+        {
+            ++i;
+        }
+
+        // Numbers aren't words
+        if (i - start >= minimumWordLength &&
+            !text[start].isDigit())
+        {
+            words.append(text.mid(start, i - start));
+        }
+    }
+
+    return words;
+}
+
+void QWordIndex::addWords(const QVector<QString>& words)
+{
+    for (auto& word : words)
+    {
+        ++m_frequencies[word];
+    }
+}
+
+void QWordIndex::removeWords(const QVector<QString>& words)
+{
+    for (auto& word : words)
+    {
+        auto it = m_frequencies.find(word);
+
+        if (it != m_frequencies.end() && --it.value() <= 0)
+        {
+            m_frequencies.erase(it);
+        }
+    }
+}
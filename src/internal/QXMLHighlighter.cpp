@@ -19,9 +19,12 @@ QXMLHighlighter::QXMLHighlighter(QTextDocument* document) :
         << QRegularExpression("<")
         << QRegularExpression("</")
         << QRegularExpression("\\?>");
+
+    setElementIndexEnabled(true);
+    setCommentTokens(QString(), {"<!--", "-->"});
 }
 
-void QXMLHighlighter::highlightBlock(const QString& text)
+void QXMLHighlighter::highlightSyntax(const QString& text)
 {
     // Special treatment for xml element regex as we use captured text to emulate lookbehind
     auto matchIterator = m_xmlElementRegex.globalMatch(text);
@@ -29,10 +32,10 @@ void QXMLHighlighter::highlightBlock(const QString& text)
     {
         auto match = matchIterator.next();
 
-        setFormat(
+        setStyleFormat(
             match.capturedStart(),
             match.capturedLength(),
-            syntaxStyle()->getFormat("Keyword") // XML ELEMENT FORMAT
+            "Keyword" // XML ELEMENT FORMAT
         );
     }
 
@@ -41,14 +44,14 @@ void QXMLHighlighter::highlightBlock(const QString& text)
     for (auto&& regex : m_xmlKeywordRegexes)
     {
         highlightByRegex(
-            syntaxStyle()->getFormat("Keyword"),
+            "Keyword",
             regex,
             text
         );
     }
 
     highlightByRegex(
-        syntaxStyle()->getFormat("Text"),
+        "Text",
         m_xmlAttributeRegex,
         text
     );
@@ -78,23 +81,68 @@ void QXMLHighlighter::highlightBlock(const QString& text)
             commentLength = endIndex - startIndex + match.capturedLength();
         }
 
-        setFormat(
+        setStyleFormat(
             startIndex,
             commentLength,
-            syntaxStyle()->getFormat("Comment")
+            "Comment"
         );
 
         startIndex = text.indexOf(m_xmlCommentBeginRegex, startIndex + commentLength);
     }
 
     highlightByRegex(
-        syntaxStyle()->getFormat("String"),
+        "String",
         m_xmlValueRegex,
         text
     );
 }
 
-void QXMLHighlighter::highlightByRegex(const QTextCharFormat& format, const QRegularExpression& regex, const QString& text)
+QVector<QSyntaxBlockData::Bracket> QXMLHighlighter::blockElements(const QString& text,
+                                                                  const QSyntaxBlockData* data) const
+{
+    QVector<QSyntaxBlockData::Bracket> elements;
+
+    for (auto i = 0; i < text.size(); ++i)
+    {
+        if (text[i] != '<' && text[i] != '/')
+        {
+            continue;
+        }
+
+        if (data->tokenAt(i) != QSyntaxBlockData::TokenType::Code)
+        {
+            continue;
+        }
+
+        auto next = i + 1 < text.size() ? text[i + 1] : QChar();
+
+        if (text[i] == '<')
+        {
+            // Processing instructions and declarations
+            if (next == '?' || next == '!')
+            {
+                continue;
+            }
+
+            elements.append({i, QLatin1Char(next == '/' ? ')' : '(')});
+        }
+        else if (next == '>')
+        {
+            // Self closing tag
+            elements.append({i, QLatin1Char(')')});
+        }
+    }
+
+    return elements;
+}
+
+QStyleSyntaxHighlighter::BlockIndentation QXMLHighlighter::blockIndentation(const QString& text,
+                                                                           const QSyntaxBlockData* data) const
+{
+    return bracketIndentation(text, data ? data->elementData() : nullptr);
+}
+
+void QXMLHighlighter::highlightByRegex(const QString& formatName, const QRegularExpression& regex, const QString& text)
 {
     auto matchIterator = regex.globalMatch(text);
 
@@ -102,10 +150,10 @@ void QXMLHighlighter::highlightByRegex(const QTextCharFormat& format, const QReg
     {
         auto match = matchIterator.next();
 
-        setFormat(
+        setStyleFormat(
             match.capturedStart(),
             match.capturedLength(),
-            format
+            formatName
         );
     }
 }
@@ -0,0 +1,282 @@
+// QCodeEditor
+#include <QCodeEditor>
+#include <QCXXHighlighter>
+#include <QCompletionListModel>
+
+// Qt
+#include <QtTest>
+#include <QTextDocument>
+#include <QTextBlock>
+#include <QElapsedTimer>
+
+/**
+ * @brief Class, that measures QCodeEditor operations
+ * on big documents. Time limits are only checked in
+ * release builds.
+ */
+class BenchmarkCodeEditor : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void reindent();
+
+    void indentSelection();
+
+    void sortLines();
+
+    void keystrokeLatency();
+
+    void completionPrefix();
+
+private:
+
+    /**
+     * @brief Method for generating C++ code without
+     * indentation.
+     * @param lines Number of lines.
+     */
+    static QString unindentedCode(int lines);
+
+    /**
+     * @brief Method for generating lines in
+     * pseudorandom order.
+     * @param lines Number of lines.
+     */
+    static QString shuffledLines(int lines);
+
+    /**
+     * @brief Method for generating identifiers in
+     * pseudorandom order.
+     * @param count Number of identifiers.
+     */
+    static QStringList identifiers(int count);
+};
+
+QString BenchmarkCodeEditor::unindentedCode(int lines)
+{
+    QStringList result;
+    result.reserve(lines);
+
+    while (result.size() < lines)
+    {
+        result << "void function()"
+               << "{"
+               << "if (value)"
+               << "{"
+               << "value = call(value, 1);"
+               << "}"
+               << "}";
+    }
+
+    return result.mid(0, lines).join('\n');
+}
+
+QString BenchmarkCodeEditor::shuffledLines(int lines)
+{
+    QStringList result;
+    result.reserve(lines);
+
+    // Linear congruential generator keeps runs comparable
+    quint32 state = 2463534242u;
+
+    for (auto i = 0; i < lines; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+
+        result << QString("line %1").arg(state % 1000000u, 6, 10, QChar('0'));
+    }
+
+    return result.join('\n');
+}
+
+QStringList BenchmarkCodeEditor::identifiers(int count)
+{
+    static const QStringList parts = {
+        "get", "set", "First", "Visible", "Block", "Count", "value", "Text", "Cursor", "Line"
+    };
+
+    QStringList result;
+    result.reserve(count);
+
+    quint32 state = 2463534242u;
+
+    for (auto i = 0; i < count; ++i)
+    {
+        QString identifier;
+
+        for (auto part = 0; part < 3; ++part)
+        {
+            state = state * 1664525u + 1013904223u;
+            identifier += parts[(state >> 8) % parts.size()];
+        }
+
+        result << identifier + QString::number(i);
+    }
+
+    return result;
+}
+
+void BenchmarkCodeEditor::reindent()
+{
+    static const int lines = 100000;
+
+    QCXXHighlighter highlighter;
+    QCodeEditor editor;
+    editor.setHighlighter(&highlighter);
+    editor.setPlainText(unindentedCode(lines));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QBENCHMARK_ONCE
+    {
+        editor.reindent();
+    }
+
+    auto elapsed = timer.elapsed();
+
+    QCOMPARE(editor.document()->findBlockByNumber(4).text(),
+             QString(8, ' ') + "value = call(value, 1);");
+
+#ifdef QT_NO_DEBUG
+    QVERIFY2(elapsed < 1000, qPrintable(QString("%1 ms").arg(elapsed)));
+#else
+    Q_UNUSED(elapsed)
+#endif
+
+    // Deferred highlighting is finished in background
+    QTRY_VERIFY_WITH_TIMEOUT(!highlighter.hasPendingBlocks(), 60000);
+}
+
+void BenchmarkCodeEditor::indentSelection()
+{
+    static const int lines = 10000;
+
+    QCXXHighlighter highlighter;
+    QCodeEditor editor;
+    editor.setHighlighter(&highlighter);
+
+    auto code = unindentedCode(lines);
+    editor.setPlainText(code);
+    editor.selectAll();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QBENCHMARK_ONCE
+    {
+        editor.indentSelection();
+        editor.unindentSelection();
+    }
+
+    auto elapsed = timer.elapsed();
+
+    QCOMPARE(editor.toPlainText(), code);
+
+    // Selection covers the same lines after both edits
+    QCOMPARE(editor.textCursor().selectionStart(), 0);
+    QCOMPARE(editor.textCursor().selectionEnd(), code.size());
+
+#ifdef QT_NO_DEBUG
+    QVERIFY2(elapsed < 500, qPrintable(QString("%1 ms").arg(elapsed)));
+#else
+    Q_UNUSED(elapsed)
+#endif
+}
+
+void BenchmarkCodeEditor::sortLines()
+{
+    static const int lines = 1000000;
+
+    QCodeEditor editor;
+    editor.setPlainText(shuffledLines(lines));
+    editor.selectAll();
+
+    QBENCHMARK_ONCE
+    {
+        editor.sortLines();
+    }
+
+    QCOMPARE(editor.document()->blockCount(), lines);
+
+    auto previous = editor.document()->begin();
+
+    for (auto block = previous.next(); block.isValid(); block = block.next())
+    {
+        QVERIFY(previous.text() <= block.text());
+        previous = block;
+    }
+}
+
+void BenchmarkCodeEditor::keystrokeLatency()
+{
+    QCXXHighlighter highlighter;
+    QCodeEditor editor;
+    editor.setHighlighter(&highlighter);
+
+    // Long indented block. Characters around cursor and
+    // indentation are read on every keystroke
+    editor.setPlainText(
+        "void function()\n{\n" +
+        QString(8, ' ') + QString("value = call(value, 1); ").repeated(4000) +
+        "\n}\n" +
+        unindentedCode(10000)
+    );
+
+    auto cursor = editor.textCursor();
+    cursor.setPosition(editor.document()->findBlockByNumber(2).position() + 50000);
+    editor.setTextCursor(cursor);
+
+    QBENCHMARK
+    {
+        QTest::keyClick(&editor, Qt::Key_A);
+        QTest::keyClick(&editor, Qt::Key_ParenLeft);
+        QTest::keyClick(&editor, Qt::Key_Return);
+        QTest::keyClick(&editor, Qt::Key_Backspace);
+    }
+}
+
+void BenchmarkCodeEditor::completionPrefix()
+{
+    static const int words = 500000;
+    static const int calls = 100;
+
+    QCompletionListModel model(identifiers(words));
+    QStringList documentWords = identifiers(100);
+
+    QCOMPARE(model.words().size(), words);
+
+    // QBENCHMARK may repeat the loop
+    auto iterations = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QBENCHMARK
+    {
+        for (auto i = 0; i < calls; ++i)
+        {
+            model.setCompletionPrefix(i % 2 ? "getfirst" : "SetV", documentWords);
+        }
+
+        ++iterations;
+    }
+
+    auto elapsed = timer.nsecsElapsed();
+
+    QVERIFY(model.rowCount() > 0);
+
+    auto callTime = static_cast<double>(elapsed) / (iterations * calls) / 1000000.0;
+
+#ifdef QT_NO_DEBUG
+    QVERIFY2(callTime < 1.0, qPrintable(QString("%1 ms").arg(callTime)));
+#else
+    Q_UNUSED(callTime)
+#endif
+}
+
+QTEST_MAIN(BenchmarkCodeEditor)
+
+#include "BenchmarkCodeEditor.moc"
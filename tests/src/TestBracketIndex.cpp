@@ -0,0 +1,379 @@
+// QCodeEditor
+#include <QBracketIndex>
+#include <QCXXHighlighter>
+#include <QCodeEditor>
+#include <QSyntaxStyle>
+#include <QSyntaxBlockData>
+
+// Qt
+#include <QtTest>
+#include <QTextDocument>
+#include <QTextCursor>
+#include <QTextBlock>
+
+// C++ STL
+#include <algorithm>
+
+/**
+ * @brief Class, that tests bracket index, that's
+ * updated by highlighter.
+ */
+class TestBracketIndex : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void matchAcrossBlocks();
+
+    void skipStringsAndComments();
+
+    void searchLimit();
+
+    void integrityAfterEdits();
+
+    void enclosingBrackets_data();
+    void enclosingBrackets();
+
+    void jumpToEnclosingParenthesis();
+
+    void selectEnclosingBlockExtendsOutward();
+
+private:
+
+    /**
+     * @brief Method for searching matching bracket
+     * in document text by depth.
+     * @return Position of matching bracket or -1.
+     */
+    static int scanMatchingBracket(const QTextDocument& document, int position);
+
+    /**
+     * @brief Method for matching bracket at document
+     * position with index.
+     */
+    static int findMatchingBracket(const QCXXHighlighter& highlighter,
+                                   const QTextDocument& document,
+                                   int position,
+                                   int blockLimit=0);
+
+    /**
+     * @brief Method for checking index against
+     * document text, which has no strings and comments.
+     */
+    static void verifyIndex(const QCXXHighlighter& highlighter,
+                            const QTextDocument& document);
+};
+
+int TestBracketIndex::scanMatchingBracket(const QTextDocument& document, int position)
+{
+    auto text = document.toPlainText();
+    auto direction = QSyntaxBlockData::isOpeningBracket(text[position]) ? 1 : -1;
+    auto depth = 0;
+
+    for (auto i = position; i >= 0 && i < text.size(); i += direction)
+    {
+        if (!QSyntaxBlockData::isBracket(text[i]))
+        {
+            continue;
+        }
+
+        depth += QSyntaxBlockData::isOpeningBracket(text[i]) == (direction > 0) ? 1 : -1;
+
+        if (depth == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+int TestBracketIndex::findMatchingBracket(const QCXXHighlighter& highlighter,
+                                          const QTextDocument& document,
+                                          int position,
+                                          int blockLimit)
+{
+    auto block = document.findBlock(position);
+
+    return highlighter.bracketIndex()->findMatchingBracket(
+        block,
+        position - block.position(),
+        blockLimit
+    );
+}
+
+void TestBracketIndex::verifyIndex(const QCXXHighlighter& highlighter,
+                                   const QTextDocument& document)
+{
+    auto index = highlighter.bracketIndex();
+
+    QCOMPARE(index->blockCount(), document.blockCount());
+    QVERIFY(index->isComplete(&document));
+
+    auto text = document.toPlainText();
+    auto depth = 0;
+
+    for (auto block = document.begin(); block.isValid(); block = block.next())
+    {
+        QCOMPARE(index->depthAt(block), depth);
+
+        for (auto i = block.position(); i < block.position() + block.length() - 1; ++i)
+        {
+            if (!QSyntaxBlockData::isBracket(text[i]))
+            {
+                continue;
+            }
+
+            depth += QSyntaxBlockData::isOpeningBracket(text[i]) ? 1 : -1;
+
+            QCOMPARE(findMatchingBracket(highlighter, document, i),
+                     scanMatchingBracket(document, i));
+        }
+    }
+}
+
+void TestBracketIndex::matchAcrossBlocks()
+{
+    QTextDocument document;
+    document.setPlainText("f(a,\n  {b[1],\n   c},\n  d)\n[)");
+
+    QCXXHighlighter highlighter;
+    highlighter.setSyntaxStyle(QSyntaxStyle::defaultStyle());
+    highlighter.setDocument(&document);
+    highlighter.rehighlight();
+
+    auto text = document.toPlainText();
+
+    QCOMPARE(findMatchingBracket(highlighter, document, 1), text.indexOf("d)") + 1);
+    QCOMPARE(findMatchingBracket(highlighter, document, text.indexOf("d)") + 1), 1);
+    QCOMPARE(findMatchingBracket(highlighter, document, text.indexOf('{')), text.indexOf('}'));
+    QCOMPARE(findMatchingBracket(highlighter, document, text.indexOf('}')), text.indexOf('{'));
+
+    // Brackets are matched by depth, not type
+    QCOMPARE(findMatchingBracket(highlighter, document, text.lastIndexOf('[')),
+             text.lastIndexOf(')'));
+
+    // Not a bracket
+    QCOMPARE(findMatchingBracket(highlighter, document, 0), -1);
+}
+
+void TestBracketIndex::skipStringsAndComments()
+{
+    QTextDocument document;
+    document.setPlainText("f(\"(\", // )\n/* ( */ x)");
+
+    QCXXHighlighter highlighter;
+    highlighter.setSyntaxStyle(QSyntaxStyle::defaultStyle());
+    highlighter.setDocument(&document);
+    highlighter.rehighlight();
+
+    auto text = document.toPlainText();
+
+    QCOMPARE(findMatchingBracket(highlighter, document, 1), text.size() - 1);
+    QCOMPARE(findMatchingBracket(highlighter, document, text.size() - 1), 1);
+
+    // Bracket inside of string isn't indexed
+    QCOMPARE(findMatchingBracket(highlighter, document, 3), -1);
+
+    // Comment is reopened by edit
+    QTextCursor cursor(&document);
+    cursor.setPosition(text.indexOf("x)"));
+    cursor.insertText("/* ");
+
+    QCOMPARE(findMatchingBracket(highlighter, document, 1), -1);
+}
+
+void TestBracketIndex::searchLimit()
+{
+    QTextDocument document;
+    document.setPlainText("(\n\n\n)");
+
+    QCXXHighlighter highlighter;
+    highlighter.setSyntaxStyle(QSyntaxStyle::defaultStyle());
+    highlighter.setDocument(&document);
+    highlighter.rehighlight();
+
+    QCOMPARE(findMatchingBracket(highlighter, document, 0, 3), 4);
+    QCOMPARE(findMatchingBracket(highlighter, document, 0, 2), -1);
+    QCOMPARE(findMatchingBracket(highlighter, document, 4, 2), -1);
+    QCOMPARE(findMatchingBracket(highlighter, document, 4, 0), 0);
+}
+
+void TestBracketIndex::integrityAfterEdits()
+{
+    static const QString alphabet = "ab ()[]{}\n\n";
+
+    // Linear congruential generator keeps runs comparable
+    quint32 state = 2463534242u;
+
+    auto next = [&state](int bound)
+    {
+        state = state * 1664525u + 1013904223u;
+
+        return static_cast<int>((state >> 8) % static_cast<quint32>(bound));
+    };
+
+    auto randomText = [&](int size)
+    {
+        QString text;
+
+        for (auto i = 0; i < size; ++i)
+        {
+            text += alphabet[next(alphabet.size())];
+        }
+
+        return text;
+    };
+
+    QTextDocument document;
+    document.setPlainText(randomText(400));
+
+    QCXXHighlighter highlighter;
+    highlighter.setSyntaxStyle(QSyntaxStyle::defaultStyle());
+    highlighter.setDocument(&document);
+    highlighter.rehighlight();
+
+    verifyIndex(highlighter, document);
+
+    for (auto i = 0; i < 200; ++i)
+    {
+        auto size = document.characterCount() - 1;
+
+        QTextCursor cursor(&document);
+        cursor.setPosition(next(size + 1));
+
+        switch (next(4))
+        {
+        case 0:
+            // Block split
+            cursor.insertText("\n");
+            break;
+        case 1:
+            // Block merge
+            cursor.movePosition(QTextCursor::EndOfBlock);
+            cursor.deleteChar();
+            break;
+        case 2:
+            // Deletion of whole blocks
+            cursor.movePosition(QTextCursor::StartOfBlock);
+            cursor.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, 1 + next(4));
+            cursor.removeSelectedText();
+            break;
+        default:
+            cursor.setPosition(std::min(cursor.position() + next(20), size), QTextCursor::KeepAnchor);
+            cursor.insertText(randomText(next(20)));
+            break;
+        }
+
+        verifyIndex(highlighter, document);
+
+        if (QTest::currentTestFailed())
+        {
+            QFAIL(qPrintable(QString("Edit %1 broke index").arg(i)));
+        }
+    }
+}
+
+void TestBracketIndex::enclosingBrackets_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("position");
+    QTest::addColumn<int>("opening");
+    QTest::addColumn<int>("closing");
+
+    QTest::newRow("nested") << "f(a, {b[1]})" << 8 << 7 << 9;
+    QTest::newRow("between") << "f(a, {b[1]})" << 10 << 5 << 10;
+    QTest::newRow("on opening") << "f(a, {b[1]})" << 5 << 1 << 11;
+    QTest::newRow("on closing") << "f(a, {b[1]})" << 9 << 7 << 9;
+    QTest::newRow("after closing") << "f(a, {b[1]})" << 12 << -1 << -1;
+    QTest::newRow("across blocks") << "{\n  a\n}" << 4 << 0 << 6;
+    QTest::newRow("unmatched opening") << "((a)" << 4 << 0 << -1;
+    QTest::newRow("unmatched closing") << "a) (b)" << 4 << 3 << 5;
+    QTest::newRow("top level") << "a) (b)" << 0 << -1 << 1;
+}
+
+void TestBracketIndex::enclosingBrackets()
+{
+    QFETCH(QString, text);
+    QFETCH(int, position);
+    QFETCH(int, opening);
+    QFETCH(int, closing);
+
+    QTextDocument document;
+    document.setPlainText(text);
+
+    QCXXHighlighter highlighter;
+    highlighter.setSyntaxStyle(QSyntaxStyle::defaultStyle());
+    highlighter.setDocument(&document);
+    highlighter.rehighlight();
+
+    auto block = document.findBlock(position);
+
+    QCOMPARE(
+        highlighter.bracketIndex()->findEnclosingBrackets(block, position - block.position()),
+        qMakePair(opening, closing)
+    );
+}
+
+void TestBracketIndex::jumpToEnclosingParenthesis()
+{
+    QCXXHighlighter highlighter;
+    QCodeEditor editor;
+    editor.setHighlighter(&highlighter);
+    editor.setPlainText("f(a, {b[1]}) )");
+
+    auto jump = [&editor](int position)
+    {
+        auto cursor = editor.textCursor();
+        cursor.setPosition(position);
+        editor.setTextCursor(cursor);
+
+        editor.jumpToEnclosingParenthesis();
+
+        return editor.textCursor().position();
+    };
+
+    QCOMPARE(jump(8), 7);
+    QCOMPARE(jump(7), 5);
+    QCOMPARE(jump(5), 1);
+
+    // Cursor stays at top level
+    QCOMPARE(jump(0), 0);
+    QCOMPARE(jump(13), 13);
+}
+
+void TestBracketIndex::selectEnclosingBlockExtendsOutward()
+{
+    QCXXHighlighter highlighter;
+    QCodeEditor editor;
+    editor.setHighlighter(&highlighter);
+    editor.setPlainText("g(f(a, {\n  b[1]\n}), c) )");
+
+    auto text = editor.toPlainText();
+
+    auto cursor = editor.textCursor();
+    cursor.setPosition(text.indexOf('1'));
+    editor.setTextCursor(cursor);
+
+    QStringList selections;
+
+    for (auto i = 0; i < 5; ++i)
+    {
+        editor.selectEnclosingBlock();
+        selections << editor.textCursor().selectedText().replace(QChar::ParagraphSeparator, '\n');
+    }
+
+    // Unmatched closing bracket isn't selected
+    QCOMPARE(selections, QStringList({
+        "[1]",
+        "{\n  b[1]\n}",
+        "(a, {\n  b[1]\n})",
+        "(f(a, {\n  b[1]\n}), c)",
+        "(f(a, {\n  b[1]\n}), c)"
+    }));
+}
+
+QTEST_MAIN(TestBracketIndex)
+
+#include "TestBracketIndex.moc"
@@ -0,0 +1,474 @@
+// QCodeEditor
+#include <QCXXSyntaxParser>
+#include <QCXXHighlighter>
+#include <QSyntaxStyle>
+#include <QSyntaxBlockData>
+
+// Qt
+#include <QtTest>
+#include <QTextDocument>
+#include <QTextCursor>
+#include <QTextBlock>
+
+/**
+ * @brief Class, that tests incremental C++ parser
+ * and its use by highlighter.
+ */
+class TestCXXSyntaxParser : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void spans();
+
+    void parentNode();
+
+    void parentNodeMatchesLinearSearch();
+
+    void rawStrings_data();
+    void rawStrings();
+
+    void multilineRawString();
+
+    void editRelexesChangedBlocksOnly();
+
+    void editMatchesFullParse();
+
+    void highlighterRehighlightsParsedChange();
+
+    void highlighterFollowsDocument();
+
+private:
+
+    /**
+     * @brief Method for converting parser spans of
+     * whole document to comparable strings.
+     */
+    static QStringList spanList(const QCXXSyntaxParser& parser,
+                                const QTextDocument& document);
+
+    /**
+     * @brief Method for connecting parser to document
+     * edits without highlighter.
+     */
+    static void attach(QCXXSyntaxParser& parser, QTextDocument& document);
+
+    /**
+     * @brief Method for finding unmatched bracket
+     * before or after position by scanning text.
+     */
+    static int unmatchedBracket(const QString& text, int position, bool forward);
+
+    /**
+     * @brief Method for finding enclosing bracket pair
+     * by scanning text level by level.
+     */
+    static QPair<int, int> linearParentNode(const QString& text, int start, int end);
+};
+
+QStringList TestCXXSyntaxParser::spanList(const QCXXSyntaxParser& parser,
+                                          const QTextDocument& document)
+{
+    QStringList result;
+
+    for (auto& span : parser.spans(0, document.characterCount()))
+    {
+        result << QString("%1:%2:%3").arg(span.start).arg(span.length).arg(span.formatName);
+    }
+
+    return result;
+}
+
+void TestCXXSyntaxParser::attach(QCXXSyntaxParser& parser, QTextDocument& document)
+{
+    parser.reset(&document);
+
+    QObject::connect(
+        &document,
+        &QTextDocument::contentsChange,
+        [&parser, &document](int position, int charsRemoved, int charsAdded)
+        {
+            parser.edit(&document, position, charsRemoved, charsAdded);
+        }
+    );
+}
+
+int TestCXXSyntaxParser::unmatchedBracket(const QString& text, int position, bool forward)
+{
+    auto depth = 0;
+
+    for (auto i = forward ? position : position - 1;
+         i >= 0 && i < text.size();
+         i += forward ? 1 : -1)
+    {
+        if (!QSyntaxBlockData::isBracket(text[i]))
+        {
+            continue;
+        }
+
+        if (QSyntaxBlockData::isOpeningBracket(text[i]) == forward)
+        {
+            ++depth;
+        }
+        else if (depth-- == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+QPair<int, int> TestCXXSyntaxParser::linearParentNode(const QString& text, int start, int end)
+{
+    auto opening = unmatchedBracket(text, start, false);
+
+    while (opening >= 0)
+    {
+        auto closing = unmatchedBracket(text, opening + 1, true);
+
+        if (closing < 0)
+        {
+            break;
+        }
+
+        if (closing + 1 >= end)
+        {
+            return {opening, closing + 1};
+        }
+
+        opening = unmatchedBracket(text, opening, false);
+    }
+
+    return {-1, -1};
+}
+
+void TestCXXSyntaxParser::spans()
+{
+    QTextDocument document;
+    document.setPlainText("int a = 10; // c\n/* x\ny */ \"s(\"\n#include");
+
+    QCXXSyntaxParser parser;
+    parser.reset(&document);
+
+    QCOMPARE(spanList(parser, document), QStringList({
+        "0:3:PrimitiveType",
+        "8:2:Number",
+        "12:4:Comment",
+        "17:4:Comment",
+        "22:4:Comment",
+        "27:4:String",
+        "32:8:Preprocessor"
+    }));
+
+    QCOMPARE(parser.spans(18, 19).size(), 1);
+}
+
+void TestCXXSyntaxParser::parentNode()
+{
+    QTextDocument document;
+    document.setPlainText("f(a, \")\", {b[1]});");
+
+    QCXXSyntaxParser parser;
+    parser.reset(&document);
+
+    // Bracket inside of string is skipped
+    QCOMPARE(parser.parentNode(3, 3), qMakePair(1, 17));
+    QCOMPARE(parser.parentNode(13, 14), qMakePair(12, 15));
+    QCOMPARE(parser.parentNode(12, 13), qMakePair(10, 16));
+    QCOMPARE(parser.parentNode(10, 16), qMakePair(1, 17));
+    QCOMPARE(parser.parentNode(0, 0), qMakePair(-1, -1));
+}
+
+void TestCXXSyntaxParser::parentNodeMatchesLinearSearch()
+{
+    static const QString characters = "(){}[]a \n";
+
+    // Linear congruential generator keeps runs comparable
+    quint32 state = 2463534242u;
+
+    auto random = [&state](int bound)
+    {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<int>((state >> 8) % static_cast<quint32>(bound));
+    };
+
+    QString text;
+
+    for (auto i = 0; i < 20000; ++i)
+    {
+        text += characters[random(characters.size())];
+    }
+
+    QTextDocument document;
+    document.setPlainText(text);
+
+    QCXXSyntaxParser parser;
+    attach(parser, document);
+
+    for (auto step = 0; step < 200; ++step)
+    {
+        // Edits change brackets in and across blocks
+        QTextCursor cursor(&document);
+        cursor.setPosition(random(document.characterCount() - 1));
+        cursor.setPosition(
+            std::min(cursor.position() + random(20), document.characterCount() - 1),
+            QTextCursor::KeepAnchor
+        );
+
+        QString inserted;
+
+        for (auto i = random(10); i > 0; --i)
+        {
+            inserted += characters[random(characters.size())];
+        }
+
+        cursor.insertText(inserted);
+
+        auto plainText = document.toPlainText();
+
+        for (auto query = 0; query < 10; ++query)
+        {
+            // Empty, short and long ranges
+            auto start = random(plainText.size() + 1);
+            auto length = random(3);
+            auto end = std::min(plainText.size(), start + length * random(200));
+
+            QCOMPARE(parser.parentNode(start, end), linearParentNode(plainText, start, end));
+        }
+    }
+}
+
+void TestCXXSyntaxParser::rawStrings_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("length");
+
+    QTest::newRow("quotes") << "R\"(a \"b\" \\)\";" << 12;
+    QTest::newRow("delimiter") << "R\"end(a)\" )\")end\";" << 17;
+    QTest::newRow("prefix") << "u8R\"(x)\";" << 8;
+    QTest::newRow("not raw") << "R \"(x)\";" << 0;
+    QTest::newRow("identifier") << "BR\"(x)\";" << 0;
+}
+
+void TestCXXSyntaxParser::rawStrings()
+{
+    QFETCH(QString, text);
+    QFETCH(int, length);
+
+    QTextDocument document;
+    document.setPlainText("f(" + text + ");");
+
+    QCXXSyntaxParser parser;
+    parser.reset(&document);
+
+    auto spans = parser.spans(2, document.characterCount());
+
+    QVERIFY(!spans.isEmpty());
+
+    // Raw string is one string token
+    if (length > 0)
+    {
+        QCOMPARE(spans.first().start, 2);
+        QCOMPARE(spans.first().length, length);
+        QCOMPARE(spans.first().formatName, QString("String"));
+    }
+    else
+    {
+        QVERIFY(spans.first().start > 2);
+    }
+
+    // Parentheses inside of raw string aren't brackets
+    QCOMPARE(parser.parentNode(3, 3), qMakePair(1, document.characterCount() - 2));
+}
+
+void TestCXXSyntaxParser::multilineRawString()
+{
+    QTextDocument document;
+    document.setPlainText("f(R\"(\n) ( \"\n)\"); g(1);");
+
+    QCXXSyntaxParser parser;
+    attach(parser, document);
+
+    QCOMPARE(spanList(parser, document), QStringList({
+        "2:3:String",
+        "6:5:String",
+        "12:2:String",
+        "19:1:Number"
+    }));
+
+    // Brackets inside of raw string are skipped
+    QCOMPARE(parser.parentNode(8, 8), qMakePair(1, 15));
+    QCOMPARE(parser.parentNode(19, 19), qMakePair(18, 21));
+
+    // Closing sequence with other delimiter doesn't
+    // end raw string
+    QTextCursor cursor(&document);
+    cursor.setPosition(4);
+    cursor.insertText("x");
+
+    QCOMPARE(parser.lexedBlocks(), 3);
+    QCOMPARE(parser.spans(0, document.characterCount()).size(), 3);
+    QCOMPARE(parser.parentNode(20, 20), qMakePair(-1, -1));
+
+    cursor.setPosition(document.findBlockByNumber(1).position());
+    cursor.insertText(")x\"");
+
+    QCOMPARE(parser.lexedBlocks(), 2);
+
+    QCXXSyntaxParser full;
+    full.reset(&document);
+
+    QCOMPARE(spanList(parser, document), spanList(full, document));
+}
+
+void TestCXXSyntaxParser::editRelexesChangedBlocksOnly()
+{
+    QTextDocument document;
+    document.setPlainText(QString("int value = 0;\n").repeated(10000));
+
+    QCXXSyntaxParser parser;
+    attach(parser, document);
+
+    QCOMPARE(parser.lexedBlocks(), document.blockCount());
+
+    QTextCursor cursor(document.findBlockByNumber(5000));
+    cursor.insertText("x");
+
+    QCOMPARE(parser.lexedBlocks(), 1);
+
+    cursor.insertText("\n\n");
+
+    QCOMPARE(parser.lexedBlocks(), 3);
+
+    // Block comment changes state of following blocks
+    // until it's closed
+    cursor.setPosition(document.findBlockByNumber(100).position());
+    cursor.insertText("/*");
+
+    QCOMPARE(parser.lexedBlocks(), document.blockCount() - 100);
+
+    cursor.setPosition(document.findBlockByNumber(200).position());
+    cursor.insertText("*/");
+
+    QCOMPARE(parser.lexedBlocks(), document.blockCount() - 200);
+}
+
+void TestCXXSyntaxParser::editMatchesFullParse()
+{
+    QTextDocument document;
+    document.setPlainText(QString("int f(int a) { return a; } // end\n").repeated(200));
+
+    QCXXSyntaxParser parser;
+    attach(parser, document);
+
+    struct Edit
+    {
+        int block;
+        int column;
+        int removed;
+        QString text;
+    };
+
+    const QVector<Edit> edits = {
+        {10, 0, 0, "/* open\n"},
+        {20, 4, 0, "*/"},
+        {30, 0, 40, ""},
+        {40, 3, 0, "\"str\ning\""},
+        {50, 0, 0, QString("char c;\n").repeated(5)},
+        {5, 0, 0, "/*"},
+        {5, 0, 2, ""},
+        {0, 0, 100, "#define A\n"},
+        {60, 0, 0, "R\"x("},
+        {65, 0, 0, ")y\""},
+        {70, 4, 0, ")x\""},
+        {62, 0, 0, "/*"},
+        {60, 0, 4, ""}
+    };
+
+    for (auto& edit : edits)
+    {
+        QTextCursor cursor(&document);
+        cursor.setPosition(document.findBlockByNumber(edit.block).position() + edit.column);
+        cursor.setPosition(
+            std::min(cursor.position() + edit.removed, document.characterCount() - 1),
+            QTextCursor::KeepAnchor
+        );
+        cursor.insertText(edit.text);
+
+        QCXXSyntaxParser full;
+        full.reset(&document);
+
+        QCOMPARE(spanList(parser, document), spanList(full, document));
+    }
+}
+
+void TestCXXSyntaxParser::highlighterRehighlightsParsedChange()
+{
+    QTextDocument document;
+    document.setPlainText(QString("int a = 0;\n").repeated(20));
+
+    QCXXSyntaxParser parser;
+    QCXXHighlighter highlighter(&document);
+    highlighter.setSyntaxStyle(QSyntaxStyle::defaultStyle());
+    highlighter.setParser(&parser);
+
+    // Document is rehighlighted after parser is attached
+    QCoreApplication::processEvents();
+
+    QTextCursor cursor(&document);
+    cursor.insertText("/*");
+
+    // Blocks after edited one are changed by parser
+    for (auto block = document.begin(); block.isValid(); block = block.next())
+    {
+        if (block.text().isEmpty())
+        {
+            continue;
+        }
+
+        auto data = dynamic_cast<QSyntaxBlockData*>(block.userData());
+
+        QVERIFY(data != nullptr);
+        QVERIFY(data->tokenAt(block.length() / 2) == QSyntaxBlockData::TokenType::Comment);
+    }
+}
+
+void TestCXXSyntaxParser::highlighterFollowsDocument()
+{
+    QTextDocument first;
+    QTextDocument second;
+    first.setPlainText("/*");
+    second.setPlainText("int a;");
+
+    QCXXSyntaxParser parser;
+    QCXXHighlighter highlighter(&first);
+    highlighter.setSyntaxStyle(QSyntaxStyle::defaultStyle());
+    highlighter.setParser(&parser);
+
+    // Base class method isn't hidden by highlighter
+    static_cast<QSyntaxHighlighter&>(highlighter).setDocument(&second);
+    QCoreApplication::processEvents();
+
+    // Edits of previous document aren't parsed
+    QTextCursor(&first).insertText("x");
+    QTextCursor(&second).insertText("y");
+
+    auto data = dynamic_cast<QSyntaxBlockData*>(second.begin().userData());
+    QVERIFY(data != nullptr);
+    QVERIFY(data->tokenAt(0) == QSyntaxBlockData::TokenType::Code);
+
+    highlighter.setParser(&parser);
+    QCoreApplication::processEvents();
+
+    QTextCursor(&second).insertText("/*");
+
+    data = dynamic_cast<QSyntaxBlockData*>(second.begin().userData());
+    QVERIFY(data != nullptr);
+    QVERIFY(data->tokenAt(0) == QSyntaxBlockData::TokenType::Comment);
+}
+
+QTEST_MAIN(TestCXXSyntaxParser)
+
+#include "TestCXXSyntaxParser.moc"
@@ -0,0 +1,339 @@
+// QCodeEditor
+#include <QCodeEditor>
+#include <QCXXHighlighter>
+#include <QLuaHighlighter>
+#include <QSyntaxBlockData>
+#include <QTracer>
+
+// Qt
+#include <QtTest>
+#include <QTextDocument>
+#include <QTextBlock>
+#include <QTextLayout>
+
+/**
+ * @brief Class, that tests QCodeEditor editing
+ * operations.
+ */
+class TestCodeEditor : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void cleanupWhitespaceKeepsNonBreakingSpaces();
+
+    void toggleCommentHighlightsRangeOnce_data();
+    void toggleCommentHighlightsRangeOnce();
+
+    void undoTimeWindowStartsWithStep();
+
+    void undoMemoryUsageCountsEqualLengthEdits();
+
+    void undoMemoryUsageIgnoresUndoRedo();
+
+    void expandSelectionIncludesClosingKeyword();
+
+    void indentSelectionUndoneAtOnce_data();
+    void indentSelectionUndoneAtOnce();
+
+    void inlineHintsFollowEdits();
+
+    void inlineHintsAtBlockStartGetNoSpace();
+
+private:
+
+    /**
+     * @brief Method for getting letter spacing, that's
+     * set by highlighter to character of block.
+     */
+    static qreal letterSpacing(const QTextBlock& block, int positionInBlock);
+};
+
+qreal TestCodeEditor::letterSpacing(const QTextBlock& block, int positionInBlock)
+{
+    for (auto& range : block.layout()->formats())
+    {
+        if (range.start <= positionInBlock &&
+            range.start + range.length > positionInBlock &&
+            range.format.fontLetterSpacingType() == QFont::AbsoluteSpacing)
+        {
+            return range.format.fontLetterSpacing();
+        }
+    }
+
+    return 0;
+}
+
+void TestCodeEditor::cleanupWhitespaceKeepsNonBreakingSpaces()
+{
+    QCodeEditor editor;
+
+    auto nbsp = QString(QChar(QChar::Nbsp));
+
+    editor.setPlainText("a" + nbsp + "\nb \t\n" + nbsp + "c\n");
+
+    auto result = editor.cleanupWhitespace();
+
+    QCOMPARE(result.trimmedLines, 1);
+    QCOMPARE(result.reindentedLines, 0);
+    QCOMPARE(result.finalNewlineAdded, false);
+
+    QCOMPARE(editor.document()->toRawText(),
+             "a" + nbsp + QChar(QChar::ParagraphSeparator) +
+             "b" + QChar(QChar::ParagraphSeparator) +
+             nbsp + "c" + QChar(QChar::ParagraphSeparator));
+}
+
+void TestCodeEditor::toggleCommentHighlightsRangeOnce_data()
+{
+    QTest::addColumn<bool>("deferred");
+
+    QTest::newRow("synchronous") << false;
+    QTest::newRow("deferred") << true;
+}
+
+void TestCodeEditor::toggleCommentHighlightsRangeOnce()
+{
+    QFETCH(bool, deferred);
+
+    static const int lines = 1000;
+
+    QTracer tracer;
+    QCXXHighlighter highlighter;
+    QCodeEditor editor;
+    editor.setHighlighter(&highlighter);
+    editor.setPlainText(QString("f(a[0]);\n").repeated(lines - 1) + "f(a[0]);");
+
+    if (deferred)
+    {
+        editor.setLargePasteSize(1);
+    }
+
+    editor.setTracer(&tracer);
+    editor.selectAll();
+    editor.toggleComment();
+
+    QTRY_VERIFY(!highlighter.hasPendingBlocks());
+
+    editor.setTracer(nullptr);
+
+    QCOMPARE(tracer.toJson().count("\"highlightBlock\""), lines);
+
+    for (auto block = editor.document()->begin(); block.isValid(); block = block.next())
+    {
+        QCOMPARE(block.text(), QString("// f(a[0]);"));
+
+        auto data = dynamic_cast<QSyntaxBlockData*>(block.userData());
+
+        QVERIFY(data != nullptr);
+        QVERIFY(data->brackets().empty());
+        QVERIFY(data->tokenAt(0) == QSyntaxBlockData::TokenType::Comment);
+    }
+}
+
+void TestCodeEditor::undoTimeWindowStartsWithStep()
+{
+    QCodeEditor editor;
+    editor.setUndoCoalescing(QCodeEditor::UndoCoalescing::TimeWindow);
+    editor.setUndoTimeWindow(200);
+
+    // Every pause is within window, but the whole step isn't
+    QTest::keyClick(&editor, Qt::Key_A);
+    QTest::qWait(150);
+    QTest::keyClick(&editor, Qt::Key_B);
+    QTest::qWait(150);
+    QTest::keyClick(&editor, Qt::Key_C);
+
+    QCOMPARE(editor.toPlainText(), QString("abc"));
+
+    editor.undo();
+
+    QCOMPARE(editor.toPlainText(), QString("ab"));
+}
+
+void TestCodeEditor::undoMemoryUsageCountsEqualLengthEdits()
+{
+    QCXXHighlighter highlighter;
+    QCodeEditor editor;
+    editor.setHighlighter(&highlighter);
+    editor.setPlainText("int a = 0;");
+
+    auto usage = editor.undoMemoryUsage();
+
+    // Highlighting changes formats only
+    highlighter.rehighlight();
+
+    QCOMPARE(editor.undoMemoryUsage(), usage);
+
+    auto cursor = editor.textCursor();
+    cursor.setPosition(4);
+    cursor.setPosition(5, QTextCursor::KeepAnchor);
+    editor.setTextCursor(cursor);
+
+    QTest::keyClick(&editor, Qt::Key_B);
+
+    QCOMPARE(editor.toPlainText(), QString("int b = 0;"));
+    QVERIFY(editor.undoMemoryUsage() > usage);
+}
+
+void TestCodeEditor::undoMemoryUsageIgnoresUndoRedo()
+{
+    QCodeEditor editor;
+    editor.setUndoMemoryLimit(1 << 20);
+
+    QTextCursor cursor(editor.document());
+    cursor.insertText(QString("x").repeated(200000));
+
+    auto usage = editor.undoMemoryUsage();
+
+    QVERIFY(usage > 400000);
+
+    // Replays don't add history
+    for (auto i = 0; i < 5; ++i)
+    {
+        editor.undo();
+
+        QCOMPARE(editor.undoMemoryUsage(), qint64(0));
+
+        editor.redo();
+
+        QCOMPARE(editor.undoMemoryUsage(), usage);
+    }
+
+    QCoreApplication::processEvents();
+
+    QCOMPARE(editor.document()->availableUndoSteps(), 1);
+
+    // Undone step is replaced by new one
+    editor.undo();
+    cursor.insertText("y");
+
+    QVERIFY(editor.undoMemoryUsage() < 1000);
+}
+
+void TestCodeEditor::expandSelectionIncludesClosingKeyword()
+{
+    const QString function =
+        "function f()\n"
+        "    local a = 1\n"
+        "    return a\n"
+        "end";
+
+    QLuaHighlighter highlighter;
+    QCodeEditor editor;
+    editor.setHighlighter(&highlighter);
+    editor.setPlainText(function + "\nendpoint = f()\n");
+
+    auto cursor = editor.textCursor();
+    cursor.setPosition(function.indexOf("local"));
+    editor.setTextCursor(cursor);
+
+    // Closing line is taken from Lua highlighter
+    for (auto i = 0; i < 10 && editor.textCursor().selectionStart() > 0; ++i)
+    {
+        editor.expandSelection();
+    }
+
+    QCOMPARE(editor.textCursor().selectedText(),
+             QString(function).replace('\n', QChar(QChar::ParagraphSeparator)));
+}
+
+void TestCodeEditor::indentSelectionUndoneAtOnce_data()
+{
+    QTest::addColumn<int>("key");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("indent") << int(Qt::Key_Tab) << "a\n      b\n\n    \tc\nd";
+    QTest::newRow("unindent") << int(Qt::Key_Backtab) << "a\nb\n\nc\nd";
+}
+
+void TestCodeEditor::indentSelectionUndoneAtOnce()
+{
+    QFETCH(int, key);
+    QFETCH(QString, expected);
+
+    const QString text = "a\n  b\n\n\tc\nd";
+
+    QCXXHighlighter highlighter;
+    QCodeEditor editor;
+    editor.setHighlighter(&highlighter);
+    editor.setPlainText(text);
+
+    // Selection covers lines partially
+    auto cursor = editor.textCursor();
+    cursor.setPosition(3);
+    cursor.setPosition(9, QTextCursor::KeepAnchor);
+    editor.setTextCursor(cursor);
+
+    QTest::keyClick(&editor, static_cast<Qt::Key>(key));
+
+    QCOMPARE(editor.toPlainText(), expected);
+    QCOMPARE(editor.document()->availableUndoSteps(), 1);
+
+    // Selection is extended to whole lines
+    QCOMPARE(editor.textCursor().selectedText(),
+             expected.section('\n', 1, 3).replace('\n', QChar(QChar::ParagraphSeparator)));
+
+    editor.undo();
+
+    QCOMPARE(editor.toPlainText(), text);
+    QCOMPARE(editor.document()->availableUndoSteps(), 0);
+}
+
+void TestCodeEditor::inlineHintsFollowEdits()
+{
+    QCXXHighlighter highlighter;
+    QCodeEditor editor;
+    editor.setHighlighter(&highlighter);
+    editor.setPlainText("int a = f(1, 2);");
+
+    editor.setInlineHints({{13, "y:"}, {10, "x:"}, {10, "z"}});
+
+    QCOMPARE(editor.inlineHints().size(), 2);
+    QCOMPARE(editor.inlineHints()[0].text, QString("x: z"));
+
+    auto cursor = editor.textCursor();
+    cursor.setPosition(0);
+    cursor.insertText("const ");
+
+    QCOMPARE(editor.inlineHints()[0].position, 16);
+    QCOMPARE(editor.inlineHints()[1].position, 19);
+
+    // Hint at edit position stays before inserted text
+    cursor.setPosition(16);
+    cursor.insertText("10");
+
+    QCOMPARE(editor.inlineHints()[0].position, 16);
+    QCOMPARE(editor.inlineHints()[1].position, 21);
+
+    // Hints inside of removed text are removed
+    cursor.setPosition(17);
+    cursor.setPosition(21, QTextCursor::KeepAnchor);
+    cursor.removeSelectedText();
+
+    QCOMPARE(editor.inlineHints().size(), 1);
+    QCOMPARE(editor.inlineHints()[0].position, 16);
+}
+
+void TestCodeEditor::inlineHintsAtBlockStartGetNoSpace()
+{
+    QCXXHighlighter highlighter;
+    QCodeEditor editor;
+    editor.setHighlighter(&highlighter);
+    editor.setPlainText("f(1);\n\ng(2);");
+
+    editor.setInlineHints({{0, "start"}, {2, "x:"}, {6, "empty"}});
+
+    auto first = editor.document()->begin();
+
+    // Space is reserved after previous character only
+    QVERIFY(letterSpacing(first, 0) == 0);
+    QVERIFY(letterSpacing(first, 1) > 0);
+
+    QCOMPARE(editor.inlineHints().size(), 3);
+}
+
+QTEST_MAIN(TestCodeEditor)
+
+#include "TestCodeEditor.moc"
@@ -0,0 +1,111 @@
+// QCodeEditor
+#include <QCompletionListModel>
+
+// Qt
+#include <QtTest>
+
+/**
+ * @brief Class, that tests filtering of completion
+ * model.
+ */
+class TestCompletionListModel : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void sortedWithoutDuplicates();
+
+    void prefixRange_data();
+    void prefixRange();
+
+    void documentWordsGoFirst();
+
+    void maximumRows();
+
+private:
+
+    /**
+     * @brief Method for getting all rows of model.
+     */
+    static QStringList rows(const QCompletionListModel& model);
+};
+
+QStringList TestCompletionListModel::rows(const QCompletionListModel& model)
+{
+    QStringList result;
+
+    for (auto row = 0; row < model.rowCount(); ++row)
+    {
+        result << model.data(model.index(row)).toString();
+    }
+
+    return result;
+}
+
+void TestCompletionListModel::sortedWithoutDuplicates()
+{
+    QCompletionListModel model({"beta", "alpha", "Alpha", "beta", "al"});
+
+    // Words with the same key keep case sensitive order
+    QCOMPARE(model.words(), QStringList({"al", "Alpha", "alpha", "beta"}));
+    QCOMPARE(rows(model), model.words());
+}
+
+void TestCompletionListModel::prefixRange_data()
+{
+    QTest::addColumn<QString>("prefix");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("empty") << "" << QStringList({"al", "Alpha", "alpha", "ALPS", "beta"});
+    QTest::newRow("upper case") << "AL" << QStringList({"al", "Alpha", "alpha", "ALPS"});
+    QTest::newRow("mixed case") << "aLp" << QStringList({"Alpha", "alpha", "ALPS"});
+    QTest::newRow("whole word") << "alpha" << QStringList({"Alpha", "alpha"});
+    QTest::newRow("longer than words") << "alphabet" << QStringList();
+    QTest::newRow("last word") << "B" << QStringList({"beta"});
+    QTest::newRow("after last word") << "c" << QStringList();
+    QTest::newRow("before first word") << "0" << QStringList();
+}
+
+void TestCompletionListModel::prefixRange()
+{
+    QFETCH(QString, prefix);
+    QFETCH(QStringList, expected);
+
+    QCompletionListModel model({"beta", "ALPS", "alpha", "Alpha", "al"});
+    model.setCompletionPrefix(prefix);
+
+    QCOMPARE(model.completionPrefix(), prefix);
+    QCOMPARE(rows(model), expected);
+}
+
+void TestCompletionListModel::documentWordsGoFirst()
+{
+    QCompletionListModel model({"alpha", "Alpha", "beta"});
+
+    // Completion words aren't repeated, comparison is case sensitive
+    model.setCompletionPrefix("al", {"alloc", "alpha", "ALPHA"});
+
+    QCOMPARE(rows(model), QStringList({"alloc", "ALPHA", "Alpha", "alpha"}));
+
+    model.setCompletionPrefix("al");
+
+    QCOMPARE(rows(model), QStringList({"Alpha", "alpha"}));
+}
+
+void TestCompletionListModel::maximumRows()
+{
+    QCompletionListModel model({"a1", "a2", "a3", "b"});
+    model.setMaximumRows(2);
+    model.setCompletionPrefix("a", {"a0"});
+
+    QCOMPARE(rows(model), QStringList({"a0", "a1"}));
+
+    model.setMaximumRows(0);
+
+    QCOMPARE(rows(model), QStringList({"a0", "a1", "a2", "a3"}));
+}
+
+QTEST_MAIN(TestCompletionListModel)
+
+#include "TestCompletionListModel.moc"
@@ -0,0 +1,252 @@
+// QCodeEditor
+#include <QDiagnosticIndex>
+
+// Qt
+#include <QtTest>
+
+// C++ STL
+#include <algorithm>
+
+/**
+ * @brief Class, that tests interval tree of
+ * diagnostics.
+ */
+class TestDiagnosticIndex : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void rangeQueries();
+
+    void shift_data();
+    void shift();
+
+    void overlapping();
+
+    void matchesLinearModel();
+
+private:
+
+    /**
+     * @brief Method for converting diagnostics to
+     * comparable strings.
+     */
+    static QStringList rangeList(const QVector<QDiagnostic>& diagnostics);
+
+    /**
+     * @brief Method for shifting diagnostic the way
+     * index does, one by one.
+     */
+    static void shiftDiagnostic(QDiagnostic& diagnostic,
+                                int position,
+                                int charsRemoved,
+                                int charsAdded);
+};
+
+QStringList TestDiagnosticIndex::rangeList(const QVector<QDiagnostic>& diagnostics)
+{
+    QStringList result;
+
+    for (auto& diagnostic : diagnostics)
+    {
+        result << QString("%1-%2:%3").arg(diagnostic.start).arg(diagnostic.end).arg(diagnostic.message);
+    }
+
+    return result;
+}
+
+void TestDiagnosticIndex::shiftDiagnostic(QDiagnostic& diagnostic,
+                                          int position,
+                                          int charsRemoved,
+                                          int charsAdded)
+{
+    auto removedEnd = position + charsRemoved;
+    auto delta = charsAdded - charsRemoved;
+
+    auto shiftPosition = [&](int value)
+    {
+        if (value < position)
+        {
+            return value;
+        }
+
+        return value >= removedEnd ? value + delta : position;
+    };
+
+    // Diagnostic at insertion position is moved after text,
+    // diagnostic ending at it isn't extended
+    if (diagnostic.start >= position && diagnostic.start >= removedEnd)
+    {
+        diagnostic.start += delta;
+        diagnostic.end += delta;
+        return;
+    }
+
+    diagnostic.start = shiftPosition(diagnostic.start);
+    diagnostic.end = diagnostic.end > position ? shiftPosition(diagnostic.end) : diagnostic.end;
+}
+
+void TestDiagnosticIndex::rangeQueries()
+{
+    using Severity = QDiagnostic::Severity;
+
+    QDiagnosticIndex index;
+    index.setDiagnostics({
+        {20, 30, Severity::Error, "c"},
+        {0, 5, Severity::Warning, "a"},
+        {10, 10, Severity::Information, "b"},
+        {40, 35, Severity::Error, "d"}
+    });
+
+    QCOMPARE(index.size(), 4);
+
+    // Ordered by start, end isn't before start
+    QCOMPARE(rangeList(index.diagnostics()), QStringList({"0-5:a", "10-10:b", "20-30:c", "40-40:d"}));
+
+    // Range bounds are included
+    QCOMPARE(rangeList(index.diagnostics(5, 10)), QStringList({"0-5:a", "10-10:b"}));
+    QCOMPARE(rangeList(index.diagnostics(6, 9)), QStringList());
+    QCOMPARE(rangeList(index.diagnostics(25, 25)), QStringList({"20-30:c"}));
+    QCOMPARE(rangeList(index.diagnostics(31, 100)), QStringList({"40-40:d"}));
+
+    index.clear();
+
+    QCOMPARE(index.size(), 0);
+    QCOMPARE(index.diagnostics().size(), 0);
+}
+
+void TestDiagnosticIndex::shift_data()
+{
+    QTest::addColumn<int>("position");
+    QTest::addColumn<int>("charsRemoved");
+    QTest::addColumn<int>("charsAdded");
+    QTest::addColumn<QStringList>("expected");
+
+    // Diagnostic is [10, 20)
+    QTest::newRow("insert before") << 5 << 0 << 3 << QStringList({"13-23:x"});
+    QTest::newRow("insert at start") << 10 << 0 << 3 << QStringList({"13-23:x"});
+    QTest::newRow("insert inside") << 15 << 0 << 3 << QStringList({"10-23:x"});
+    QTest::newRow("insert at end") << 20 << 0 << 3 << QStringList({"10-20:x"});
+    QTest::newRow("insert after") << 25 << 0 << 3 << QStringList({"10-20:x"});
+    QTest::newRow("remove before") << 0 << 5 << 0 << QStringList({"5-15:x"});
+    QTest::newRow("remove inside") << 12 << 5 << 0 << QStringList({"10-15:x"});
+    QTest::newRow("remove start") << 5 << 10 << 0 << QStringList({"5-10:x"});
+    QTest::newRow("remove end") << 15 << 10 << 0 << QStringList({"10-15:x"});
+    QTest::newRow("remove whole") << 5 << 20 << 2 << QStringList({"5-5:x"});
+    QTest::newRow("replace inside") << 12 << 4 << 1 << QStringList({"10-17:x"});
+}
+
+void TestDiagnosticIndex::shift()
+{
+    QFETCH(int, position);
+    QFETCH(int, charsRemoved);
+    QFETCH(int, charsAdded);
+    QFETCH(QStringList, expected);
+
+    QDiagnosticIndex index;
+    index.setDiagnostics({{10, 20, QDiagnostic::Severity::Error, "x"}});
+
+    index.shift(position, charsRemoved, charsAdded);
+
+    QCOMPARE(rangeList(index.diagnostics()), expected);
+    QCOMPARE(index.size(), 1);
+}
+
+void TestDiagnosticIndex::overlapping()
+{
+    using Severity = QDiagnostic::Severity;
+
+    QDiagnosticIndex index;
+    index.setDiagnostics({
+        {0, 100, Severity::Error, "outer"},
+        {10, 20, Severity::Warning, "first"},
+        {15, 30, Severity::Warning, "second"},
+        {50, 60, Severity::Information, "last"}
+    });
+
+    // Long diagnostic is found by maximal end of subtree
+    QCOMPARE(rangeList(index.diagnostics(70, 80)), QStringList({"0-100:outer"}));
+    QCOMPARE(rangeList(index.diagnostics(25, 25)), QStringList({"0-100:outer", "15-30:second"}));
+
+    // Removal across ends of overlapping diagnostics
+    index.shift(18, 20, 0);
+
+    QCOMPARE(rangeList(index.diagnostics()), QStringList({
+        "0-80:outer",
+        "10-18:first",
+        "15-18:second",
+        "30-40:last"
+    }));
+
+    QCOMPARE(rangeList(index.diagnostics(19, 29)), QStringList({"0-80:outer"}));
+}
+
+void TestDiagnosticIndex::matchesLinearModel()
+{
+    // Linear congruential generator keeps runs comparable
+    quint32 state = 2463534242u;
+
+    auto next = [&state](int bound)
+    {
+        state = state * 1664525u + 1013904223u;
+
+        return static_cast<int>((state >> 8) % static_cast<quint32>(bound));
+    };
+
+    QVector<QDiagnostic> expected;
+
+    for (auto i = 0; i < 500; ++i)
+    {
+        auto start = next(10000);
+
+        expected.append({start, start + next(50), QDiagnostic::Severity::Error, QString::number(i)});
+    }
+
+    QDiagnosticIndex index;
+    index.setDiagnostics(expected);
+
+    std::stable_sort(
+        expected.begin(),
+        expected.end(),
+        [](const QDiagnostic& a, const QDiagnostic& b)
+        {
+            return a.start < b.start;
+        }
+    );
+
+    for (auto i = 0; i < 300; ++i)
+    {
+        auto position = next(10000);
+        auto charsRemoved = next(3) == 0 ? next(200) : 0;
+        auto charsAdded = next(100);
+
+        index.shift(position, charsRemoved, charsAdded);
+
+        for (auto& diagnostic : expected)
+        {
+            shiftDiagnostic(diagnostic, position, charsRemoved, charsAdded);
+        }
+
+        QCOMPARE(rangeList(index.diagnostics()), rangeList(expected));
+
+        auto start = next(10000);
+        auto end = start + next(300);
+
+        QVector<QDiagnostic> intersecting;
+
+        for (auto& diagnostic : expected)
+        {
+            if (diagnostic.start <= end && diagnostic.end >= start)
+            {
+                intersecting.append(diagnostic);
+            }
+        }
+
+        QCOMPARE(rangeList(index.diagnostics(start, end)), rangeList(intersecting));
+    }
+}
+
+QTEST_MAIN(TestDiagnosticIndex)
+
+#include "TestDiagnosticIndex.moc"
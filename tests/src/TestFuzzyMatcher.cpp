@@ -0,0 +1,197 @@
+// QCodeEditor
+#include <QFuzzyMatcher>
+
+// Qt
+#include <QtTest>
+
+// C++ STL
+#include <algorithm>
+
+/**
+ * @brief Class, that tests ranking of fuzzy
+ * matcher.
+ */
+class TestFuzzyMatcher : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void camelCaseRanksFirst();
+
+    void rejectsMissingCharacters();
+
+    void threadedMatchesSingleThreaded_data();
+    void threadedMatchesSingleThreaded();
+
+private:
+
+    /**
+     * @brief Method for getting character masks
+     * of words.
+     */
+    static QVector<quint64> masks(const QVector<QString>& words);
+
+    /**
+     * @brief Method for getting generated identifiers.
+     * Equal scores are frequent, so ordering by index
+     * is checked too.
+     */
+    static QVector<QString> identifiers(int count);
+
+    /**
+     * @brief Method for matching words by scoring
+     * them one by one in the calling thread.
+     */
+    static QVector<int> reference(const QFuzzyMatcher& matcher,
+                                  const QVector<QString>& words,
+                                  int limit);
+};
+
+QVector<quint64> TestFuzzyMatcher::masks(const QVector<QString>& words)
+{
+    QVector<quint64> result;
+    result.reserve(words.size());
+
+    for (auto& word : words)
+    {
+        result.append(QFuzzyMatcher::characterMask(word));
+    }
+
+    return result;
+}
+
+QVector<QString> TestFuzzyMatcher::identifiers(int count)
+{
+    static const char* parts[] = {
+        "get", "set", "First", "Visible", "Block",
+        "Count", "value", "Text", "Cursor", "Line", "_"
+    };
+
+    QVector<QString> result;
+    result.reserve(count);
+
+    quint32 state = 2463534242u;
+
+    for (auto i = 0; i < count; ++i)
+    {
+        QString word;
+
+        for (auto j = 0; j < 4; ++j)
+        {
+            state = state * 1664525u + 1013904223u;
+            word += QLatin1String(parts[(state >> 16) % 11]);
+        }
+
+        result.append(word);
+    }
+
+    return result;
+}
+
+QVector<int> TestFuzzyMatcher::reference(const QFuzzyMatcher& matcher,
+                                         const QVector<QString>& words,
+                                         int limit)
+{
+    QVector<QPair<int, int>> matches;
+
+    for (auto i = 0; i < words.size(); ++i)
+    {
+        auto score = matcher.score(words[i]);
+
+        if (score >= 0)
+        {
+            matches.append({-score, i});
+        }
+    }
+
+    std::sort(matches.begin(), matches.end());
+
+    QVector<int> result;
+
+    for (auto i = 0; i < matches.size() && (limit == 0 || i < limit); ++i)
+    {
+        result.append(matches[i].second);
+    }
+
+    return result;
+}
+
+void TestFuzzyMatcher::camelCaseRanksFirst()
+{
+    QVector<QString> words = {
+        "getfirstvisibleblock",
+        "GetFirstVisibleBlockNumber",
+        "setFirstVisibleBlock",
+        "getFirstVisibleBlockCount",
+        "generateFromVisibleBlocks",
+        "getFirstVisibleBlock",
+        "firstVisibleBlock"
+    };
+
+    QFuzzyMatcher matcher("gfvb");
+
+    auto indexes = matcher.match(words, masks(words), 0);
+
+    // Words without subsequence aren't matched
+    QCOMPARE(indexes.size(), 5);
+    QCOMPARE(words[indexes.first()], QString("getFirstVisibleBlock"));
+    QVERIFY(!indexes.contains(2));
+    QVERIFY(!indexes.contains(6));
+
+    // Humps beat the same word without them
+    QVERIFY(matcher.score("getFirstVisibleBlock") > matcher.score("getfirstvisibleblock"));
+
+    // Ranking is ordered by score
+    for (auto i = 1; i < indexes.size(); ++i)
+    {
+        QVERIFY(matcher.score(words[indexes[i - 1]]) >= matcher.score(words[indexes[i]]));
+    }
+}
+
+void TestFuzzyMatcher::rejectsMissingCharacters()
+{
+    QVector<QString> words = {"getFirstVisibleBlock", "bvfg", "gfv", ""};
+
+    QFuzzyMatcher matcher("gfvb");
+
+    QCOMPARE(matcher.score("bvfg"), -1);
+    QCOMPARE(matcher.score("gfv"), -1);
+    QCOMPARE(matcher.match(words, masks(words), 0), QVector<int>({0}));
+}
+
+void TestFuzzyMatcher::threadedMatchesSingleThreaded_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<int>("limit");
+
+    QTest::newRow("humps") << "gfvb" << 100;
+    QTest::newRow("consecutive") << "text" << 100;
+    QTest::newRow("underscore") << "_c" << 1000;
+    QTest::newRow("unlimited") << "stc" << 0;
+}
+
+void TestFuzzyMatcher::threadedMatchesSingleThreaded()
+{
+    QFETCH(QString, pattern);
+    QFETCH(int, limit);
+
+    // Words are split between threads only, when
+    // there are several parts of 32k words
+    auto words = identifiers(100000);
+    auto wordMasks = masks(words);
+
+    QFuzzyMatcher matcher(pattern);
+
+    auto indexes = matcher.match(words, wordMasks, limit);
+
+    QVERIFY(!indexes.isEmpty());
+    QCOMPARE(indexes, reference(matcher, words, limit));
+
+    // Matching is repeatable
+    QCOMPARE(matcher.match(words, wordMasks, limit), indexes);
+}
+
+QTEST_MAIN(TestFuzzyMatcher)
+
+#include "TestFuzzyMatcher.moc"
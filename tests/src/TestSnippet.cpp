@@ -0,0 +1,135 @@
+// QCodeEditor
+#include <QSnippet>
+#include <QCodeEditor>
+
+// Qt
+#include <QtTest>
+#include <QTextDocument>
+
+/**
+ * @brief Class, that tests snippet parsing and
+ * expansion by QCodeEditor.
+ */
+class TestSnippet : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void parse_data();
+    void parse();
+
+    void mirrorInsidePlaceholder();
+
+    void expandWithIndentation();
+
+    void expandNestedMirror();
+
+private:
+
+    /**
+     * @brief Method for converting tab stops to
+     * comparable strings.
+     */
+    static QStringList stopList(const QSnippet& snippet);
+};
+
+QStringList TestSnippet::stopList(const QSnippet& snippet)
+{
+    QStringList result;
+
+    for (auto& stop : snippet.tabStops())
+    {
+        result << QString("%1:%2").arg(stop.number).arg(snippet.text().mid(stop.start, stop.length));
+    }
+
+    return result;
+}
+
+void TestSnippet::parse_data()
+{
+    QTest::addColumn<QString>("snippet");
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QStringList>("stops");
+
+    QTest::newRow("plain") << "abc" << "abc" << QStringList({"0:"});
+    QTest::newRow("tab stops") << "a$1b$0c" << "abc" << QStringList({"1:", "0:"});
+    QTest::newRow("placeholder") << "f(${1:x}, ${2})" << "f(x, )" << QStringList({"1:x", "2:", "0:"});
+    QTest::newRow("escapes") << "\\$1 \\} \\\\" << "$1 } \\" << QStringList({"0:"});
+    QTest::newRow("mirrors") << "${1:a} $1 $1" << "a a a" << QStringList({"1:a", "1:a", "1:a", "0:"});
+    QTest::newRow("unclosed") << "${1:abc" << "abc" << QStringList({"1:abc", "0:"});
+    QTest::newRow("dollar") << "a$ b$" << "a$ b$" << QStringList({"0:"});
+}
+
+void TestSnippet::parse()
+{
+    QFETCH(QString, snippet);
+    QFETCH(QString, text);
+    QFETCH(QStringList, stops);
+
+    QSnippet parsed(snippet);
+
+    QCOMPARE(parsed.text(), text);
+    QCOMPARE(stopList(parsed), stops);
+}
+
+void TestSnippet::mirrorInsidePlaceholder()
+{
+    QSnippet parsed("${1:foo($2)} ${2:x}");
+
+    QCOMPARE(parsed.text(), QString("foo(x) x"));
+    QCOMPARE(stopList(parsed), QStringList({"1:foo(x)", "2:x", "2:x", "0:"}));
+
+    // Mirror at placeholder start and end
+    QCOMPARE(stopList(QSnippet("${1:$2a} ${2:b}")), QStringList({"2:b", "1:ba", "2:b", "0:"}));
+    QCOMPARE(stopList(QSnippet("${1:a$2} ${2:b}")), QStringList({"1:ab", "2:b", "2:b", "0:"}));
+
+    // Mirror after placeholder isn't contained by it
+    QCOMPARE(stopList(QSnippet("${1:a}$2 ${2:b}")), QStringList({"1:a", "2:b", "2:b", "0:"}));
+}
+
+void TestSnippet::expandWithIndentation()
+{
+    QCodeEditor editor;
+    editor.setPlainText("    ");
+    editor.moveCursor(QTextCursor::End);
+
+    editor.insertSnippet("if (${1:cond})\n{\n    $0\n}");
+
+    QCOMPARE(editor.toPlainText(), QString("    if (cond)\n    {\n        \n    }"));
+    QCOMPARE(editor.textCursor().selectedText(), QString("cond"));
+    QVERIFY(editor.hasActiveSnippet());
+
+    QTest::keyClick(&editor, Qt::Key_Tab);
+
+    QCOMPARE(editor.textCursor().position(), editor.toPlainText().indexOf("\n    }"));
+    QVERIFY(!editor.hasActiveSnippet());
+}
+
+void TestSnippet::expandNestedMirror()
+{
+    QCodeEditor editor;
+
+    editor.insertSnippet("${1:foo($2)} ${2:x}");
+
+    QCOMPARE(editor.toPlainText(), QString("foo(x) x"));
+    QCOMPARE(editor.textCursor().selectedText(), QString("foo(x)"));
+
+    QTest::keyClick(&editor, Qt::Key_Tab);
+
+    QCOMPARE(editor.textCursor().selectionStart(), 4);
+    QCOMPARE(editor.textCursor().selectedText(), QString("x"));
+
+    QTest::keyClicks(&editor, "yz");
+
+    QCOMPARE(editor.toPlainText(), QString("foo(yz) yz"));
+
+    // Placeholder contains edited mirror
+    QTest::keyClick(&editor, Qt::Key_Backtab);
+
+    QCOMPARE(editor.textCursor().selectedText(), QString("foo(yz)"));
+}
+
+QTEST_MAIN(TestSnippet)
+
+#include "TestSnippet.moc"
@@ -0,0 +1,240 @@
+// QCodeEditor
+#include <QCXXHighlighter>
+#include <QSyntaxStyle>
+#include <QSyntaxBlockData>
+
+// Qt
+#include <QtTest>
+#include <QTextDocument>
+#include <QTextCursor>
+#include <QTextBlock>
+#include <QTextLayout>
+
+/**
+ * @brief Class, that tests deferred highlighting
+ * and rainbow parentheses of QStyleSyntaxHighlighter.
+ */
+class TestStyleSyntaxHighlighter : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void deferredRewriteOfExistingBlocks();
+
+    void deferredRangeFollowsEdits();
+
+    void rainbowDepthAfterUnmatchedClosing();
+
+private:
+
+    /**
+     * @brief Method for getting foreground color, that's
+     * set by highlighter to character of block.
+     */
+    static QColor foreground(const QTextBlock& block, int positionInBlock);
+
+    /**
+     * @brief Method for rewriting blocks in range with
+     * deferred highlighting. Every block gets brackets
+     * and comment, so both formats and bracket data
+     * have to be updated.
+     */
+    static void rewriteBlocks(QCXXHighlighter& highlighter,
+                              QTextDocument& document,
+                              int first,
+                              int last);
+
+    /**
+     * @brief Method for checking, that block is
+     * highlighted for its current text.
+     */
+    static bool isRewrittenBlockHighlighted(const QTextBlock& block);
+};
+
+void TestStyleSyntaxHighlighter::rewriteBlocks(QCXXHighlighter& highlighter,
+                                               QTextDocument& document,
+                                               int first,
+                                               int last)
+{
+    highlighter.setHighlightingDeferred(true);
+
+    QTextCursor cursor(&document);
+    cursor.beginEditBlock();
+
+    for (auto number = first; number <= last; ++number)
+    {
+        auto block = document.findBlockByNumber(number);
+
+        cursor.setPosition(block.position());
+        cursor.setPosition(block.position() + block.length() - 1, QTextCursor::KeepAnchor);
+        cursor.insertText("f(a[0]); // rewritten");
+    }
+
+    cursor.endEditBlock();
+
+    highlighter.setHighlightingDeferred(false);
+}
+
+bool TestStyleSyntaxHighlighter::isRewrittenBlockHighlighted(const QTextBlock& block)
+{
+    auto data = dynamic_cast<QSyntaxBlockData*>(block.userData());
+
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    auto& brackets = data->brackets();
+
+    // Brackets of "f(a[0]); // rewritten"
+    if (brackets.size() != 4 ||
+        brackets[0].position != 1 ||
+        brackets[1].position != 3 ||
+        brackets[2].position != 5 ||
+        brackets[3].position != 6)
+    {
+        return false;
+    }
+
+    if (data->tokenAt(block.text().indexOf("//")) !=
+        QSyntaxBlockData::TokenType::Comment)
+    {
+        return false;
+    }
+
+    auto comment = QSyntaxStyle::defaultStyle()->getFormat("Comment");
+
+    for (auto&& range : block.layout()->formats())
+    {
+        if (range.start == block.text().indexOf("//") &&
+            range.format == comment)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TestStyleSyntaxHighlighter::deferredRewriteOfExistingBlocks()
+{
+    QTextDocument document;
+    QCXXHighlighter highlighter(&document);
+    highlighter.setSyntaxStyle(QSyntaxStyle::defaultStyle());
+
+    QStringList lines;
+    for (auto i = 0; i < 500; ++i)
+    {
+        lines << QString("int value%1 = 0;").arg(i);
+    }
+
+    document.setPlainText(lines.join('\n'));
+    highlighter.rehighlight();
+
+    rewriteBlocks(highlighter, document, 0, document.blockCount() - 1);
+
+    QVERIFY(highlighter.hasPendingBlocks());
+
+    while (highlighter.highlightPendingBlocks(1000))
+    {
+    }
+
+    for (auto block = document.begin(); block.isValid(); block = block.next())
+    {
+        QVERIFY2(
+            isRewrittenBlockHighlighted(block),
+            qPrintable(QString("Block %1").arg(block.blockNumber()))
+        );
+    }
+}
+
+void TestStyleSyntaxHighlighter::deferredRangeFollowsEdits()
+{
+    QTextDocument document;
+    QCXXHighlighter highlighter(&document);
+    highlighter.setSyntaxStyle(QSyntaxStyle::defaultStyle());
+
+    QStringList lines;
+    for (auto i = 0; i < 300; ++i)
+    {
+        lines << QString("int value%1 = 0;").arg(i);
+    }
+
+    document.setPlainText(lines.join('\n'));
+    highlighter.rehighlight();
+
+    rewriteBlocks(highlighter, document, 100, 199);
+
+    // Lines inserted above pending range shift it
+    QTextCursor cursor(&document);
+    cursor.insertText(QString("int inserted = 0;\n").repeated(50));
+
+    while (highlighter.highlightPendingBlocks(1000))
+    {
+    }
+
+    QVERIFY(!highlighter.hasPendingBlocks());
+
+    for (auto number = 150; number < 250; ++number)
+    {
+        QVERIFY2(
+            isRewrittenBlockHighlighted(document.findBlockByNumber(number)),
+            qPrintable(QString("Block %1").arg(number))
+        );
+    }
+
+    // Blocks outside of range are kept highlighted
+    auto data = dynamic_cast<QSyntaxBlockData*>(document.findBlockByNumber(260).userData());
+    QVERIFY(data != nullptr);
+    QVERIFY(data->brackets().empty());
+}
+
+QColor TestStyleSyntaxHighlighter::foreground(const QTextBlock& block, int positionInBlock)
+{
+    for (auto& range : block.layout()->formats())
+    {
+        if (range.start <= positionInBlock &&
+            range.start + range.length > positionInBlock)
+        {
+            return range.format.foreground().color();
+        }
+    }
+
+    return QColor();
+}
+
+void TestStyleSyntaxHighlighter::rainbowDepthAfterUnmatchedClosing()
+{
+    QTextDocument edited;
+    QTextDocument expected;
+    edited.setPlainText(")\nx\n(a)");
+    expected.setPlainText("))\nx\n(a)");
+
+    QCXXHighlighter editedHighlighter;
+    QCXXHighlighter expectedHighlighter;
+
+    for (auto highlighter : {&editedHighlighter, &expectedHighlighter})
+    {
+        highlighter->setSyntaxStyle(QSyntaxStyle::defaultStyle());
+        highlighter->setRainbowParentheses(true);
+    }
+
+    editedHighlighter.setDocument(&edited);
+    expectedHighlighter.setDocument(&expected);
+    QCoreApplication::processEvents();
+
+    auto before = foreground(edited.lastBlock(), 0);
+
+    // Depth at end of edited block goes from -1 to -2
+    QTextCursor(&edited).insertText(")");
+
+    QVERIFY(before.isValid());
+    QVERIFY(foreground(edited.lastBlock(), 0) != before);
+    QCOMPARE(foreground(edited.lastBlock(), 0), foreground(expected.lastBlock(), 0));
+    QCOMPARE(foreground(edited.lastBlock(), 2), foreground(expected.lastBlock(), 2));
+}
+
+QTEST_MAIN(TestStyleSyntaxHighlighter)
+
+#include "TestStyleSyntaxHighlighter.moc"
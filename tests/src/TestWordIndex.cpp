@@ -0,0 +1,69 @@
+// QCodeEditor
+#include <QWordIndex>
+
+// Qt
+#include <QtTest>
+#include <QTextDocument>
+#include <QTextCursor>
+
+/**
+ * @brief Class, that tests index of document words.
+ */
+class TestWordIndex : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void completionsOfPrefixRange();
+
+    void updateByEditedBlocks();
+};
+
+void TestWordIndex::completionsOfPrefixRange()
+{
+    QTextDocument document;
+    document.setPlainText("value valid valid vault\nother valve\nvalue2 val");
+
+    QWordIndex index;
+    index.rebuild(&document);
+
+    // Prefix itself and words outside of prefix range are skipped
+    QCOMPARE(index.completions("val", 0, 10),
+             QStringList({"valid", "value", "valve", "value2"}));
+
+    QCOMPARE(index.completions("val", 0, 1), QStringList({"valid"}));
+    QCOMPARE(index.completions("vau", 0, 10), QStringList({"vault"}));
+    QCOMPARE(index.completions("zzz", 0, 10), QStringList());
+}
+
+void TestWordIndex::updateByEditedBlocks()
+{
+    QTextDocument document;
+    document.setPlainText("alpha\nbeta\ngamma");
+
+    QWordIndex index;
+    index.rebuild(&document);
+
+    QObject::connect(
+        &document,
+        &QTextDocument::contentsChange,
+        [&index, &document](int position, int charsRemoved, int charsAdded)
+        {
+            index.update(&document, position, charsRemoved, charsAdded);
+        }
+    );
+
+    QTextCursor cursor(document.findBlockByNumber(1));
+    cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+    cursor.insertText("alphabet\nalpine");
+
+    QCOMPARE(index.frequency("beta"), 0);
+    QCOMPARE(index.frequency("alphabet"), 1);
+    QCOMPARE(index.completions("alp", 1, 10),
+             QStringList({"alphabet", "alpha", "alpine"}));
+}
+
+QTEST_MAIN(TestWordIndex)
+
+#include "TestWordIndex.moc"